@@ -342,6 +342,47 @@ void test_sqrtTestcases( void )
 }
 
 
+void test_literals( void )
+{
+  COMMENT("Testing literals");
+  TEST(1.5_fx16 == Fix16(1.5));
+  TEST(-0.25_fx16 == Fix16(-0.25));
+  TEST(1e3_fx16 == Fix16((int16_t)1000));
+  TEST(fix16_t(0.0000152587890625_fx16) == 1);
+  TEST(fix16_t(32767.99999_fx16) == fix16_maximum);
+}
+
+void test_saturating( void )
+{
+#ifndef FIXMATH_NO_OVERFLOW
+  COMMENT("Testing saturating addition and subtraction");
+  TEST(fix16_sadd(0, fix16_minimum) == fix16_minimum);
+  TEST(fix16_sadd(fix16_minimum, 0) == fix16_minimum);
+  TEST(fix16_sadd(fix16_maximum, 1) == fix16_maximum);
+  TEST(fix16_sadd(fix16_minimum, -1) == fix16_minimum);
+  TEST(fix16_ssub(fix16_minimum, 0) == fix16_minimum);
+  TEST(fix16_ssub(0, fix16_minimum) == fix16_maximum);
+#endif
+}
+
+void test_stickyOverflow( void )
+{
+#ifdef FIXMATH_STICKY_OVERFLOW
+  fix16_t x;
+  COMMENT("Testing that sin and cos do not set the overflow flag");
+  fix16_overflow_clear();
+  for (x = -fix16_pi; x <= fix16_pi; x += 37)
+  {
+    fix16_sin(x);
+    fix16_cos(x);
+  }
+  fix16_asin(fix16_one);
+  fix16_asin(-fix16_one);
+  TEST(!fix16_overflow_occurred());
+#endif
+}
+
+
 void setup()
 {
   Serial.begin(115200);
@@ -354,6 +395,9 @@ void setup()
   test_divTestcases();
   test_addTestcases();
   test_subTestcases();
+  test_literals();
+  test_saturating();
+  test_stickyOverflow();
   test_sqrtBasic();
   test_sqrtRound();
   test_sqrtTestcases();
@@ -284,6 +284,69 @@ void test_subTestcases( void )
   TEST(failures == 0);
 }
 
+void test_literals( void )
+{
+  COMMENT("Testing literals");
+  TEST(0.25_fx8 == Fix8(0.25));
+  TEST(-1.5_fx8 == Fix8(-1.5));
+  TEST(1e2_fx8 == Fix8((int8_t)100));
+  TEST(fix8_t(0.00390625_fx8) == 1);
+  TEST(fix8_t(127.998_fx8) == fix8_maximum);
+}
+
+/* a * b + c * d + e * f of raw values, summed exactly, rounded half away
+ * from zero and saturated.
+ */
+int16_t fused_reference(const int16_t *v, int fracBits)
+{
+  int64_t sum = (int64_t)v[0] * v[1] + (int64_t)v[2] * v[3] + (int64_t)v[4] * v[5];
+  sum += ((int64_t)1 << (fracBits - 1)) - (sum < 0);
+  sum /= (int64_t)1 << fracBits;
+  if (sum > 0x7FFF)
+    return 0x7FFF;
+  if (sum < -0x8000)
+    return -0x8000;
+  return sum;
+}
+
+template <typename Fixed>
+bool fused_matches(const int16_t *v, int fracBits)
+{
+  Fixed result = fused(Fixed(v[0])) * Fixed(v[1]) + fused(Fixed(v[2])) * Fixed(v[3])
+    + fused(Fixed(v[4])) * Fixed(v[5]);
+  return result.value == fused_reference(v, fracBits);
+}
+
+void test_fusedFullScale( void )
+{
+  typedef Fix8Mode<FixedPointSaturate, FixedPointNearest> Fix8Sat;
+  typedef FixedPoint<1, 15, int16_t, FixedPointSaturate, FixedPointNearest> Q1_15;
+  typedef FixedPoint<4, 12, int16_t, FixedPointSaturate, FixedPointNearest> Q4_12;
+  // The sums of the first three exceed 32 bits.
+  const int16_t cases[][6] = {
+    { -30704, -29457, -30704, -29457, -30704, -29457 },
+    { 32767, 32767, 32767, 32767, 32767, 32767 },
+    { -32768, -32768, -32768, -32768, -32768, -32768 },
+    { -32768, 32767, -32768, 32767, -32768, 32767 },
+    { -30704, -29457, 32767, -32768, 30000, 31111 },
+    { 32767, 32767, -32768, 32767, 32767, 1 },
+    { 1, 2, -3, 4, 5, -6 }
+  };
+  unsigned int i;
+  int failures = 0;
+  COMMENT("Testing fused sums of near full scale products");
+
+  for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    failures += !fused_matches<Fix8Sat>(cases[i], 8);
+    failures += !fused_matches<Q1_15>(cases[i], 15);
+    failures += !fused_matches<Q4_12>(cases[i], 12);
+  }
+  TEST(failures == 0);
+  TEST(fused_matches<Fix8>(cases[5], 8));
+}
+
+
 void setup()
 {
   Serial.begin(115200);
@@ -296,6 +359,8 @@ void setup()
   test_divTestcases();
   test_addTestcases();
   test_subTestcases();
+  test_literals();
+  test_fusedFullScale();
 
   if (status != 0)
     Serial.println("\n\nSome tests FAILED!");
@@ -0,0 +1,364 @@
+/* Cycle-accurate AVR benchmark.
+ *
+ * Built with avr-gcc for an ATmega (see the 'avr' targets in the Makefile
+ * one directory up) and run under simavr, or flashed onto a board. Each
+ * function is called on the testcases[] set while Timer1 counts CPU cycles
+ * at prescaler 1. Results go to the UART at 115200 baud.
+ *
+ * The reported count is the cycles spent in the call, with the cost of
+ * calling an empty function with the same signature subtracted. Besides
+ * min/avg/max the latency distribution is kept in a histogram with eight
+ * buckets per power of two, the percentiles are the upper bounds of their
+ * bucket (within 12.5%). The worst case is exact and printed with its input.
+ */
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <stdio.h>
+#include <string.h>
+#include <util/delay_basic.h>
+#include <fix16.h>
+#include <fix8.h>
+#include "../testcases.h"
+
+#ifndef BAUD
+#define BAUD 115200
+#endif
+
+#ifndef AVR_MCU_NAME
+#define AVR_MCU_NAME "avr"
+#endif
+
+typedef fix16_t (*fix16_unary_t)(fix16_t);
+typedef fix16_t (*fix16_binary_t)(fix16_t, fix16_t);
+typedef fix8_t  (*fix8_binary_t)(fix8_t, fix8_t);
+
+// Values below 8 have a bucket each, above that 8 buckets per power of two,
+// up to 2^20 cycles.
+#define HIST_OCTAVES  (18)
+#define HIST_BUCKETS  (8 + 8 * HIST_OCTAVES)
+
+struct stats
+{
+	uint32_t min;
+	uint32_t max;
+	uint32_t sum;
+	uint16_t count;
+	fix16_t  worst_a;
+	fix16_t  worst_b;
+	uint16_t hist[HIST_BUCKETS];
+};
+
+// One instance for all functions, the histogram does not fit the RAM
+// of the small parts many times.
+static struct stats shared_stats;
+
+static volatile uint16_t overflows;
+static volatile fix16_t sink16;
+static volatile fix8_t sink8;
+
+// Cycles taken by one Timer1 overflow interrupt, measured at startup.
+static uint16_t isr_cycles;
+
+// Cost of the measurement itself, per function signature.
+static uint16_t overhead_unary16, overhead_binary16, overhead_binary8;
+
+ISR(TIMER1_OVF_vect)
+{
+	overflows++;
+}
+
+static int uart_putchar(char c, FILE *stream)
+{
+	if (c == '\n')
+		uart_putchar('\r', stream);
+	loop_until_bit_is_set(UCSR0A, UDRE0);
+	UCSR0A |= _BV(TXC0);
+	UDR0 = c;
+	return 0;
+}
+
+static FILE uart_stdout = FDEV_SETUP_STREAM(uart_putchar, NULL, _FDEV_SETUP_WRITE);
+
+static void uart_init(void)
+{
+	// Double speed mode gives a usable error at 115200 baud on 16MHz.
+	UCSR0A = _BV(U2X0);
+	UBRR0 = (F_CPU / 8 / BAUD) - 1;
+	UCSR0B = _BV(TXEN0);
+	UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);
+	stdout = &uart_stdout;
+}
+
+static inline void timer_start(void)
+{
+	overflows = 0;
+	TCNT1 = 0;
+	TIFR1 = _BV(TOV1);
+	TCCR1B = _BV(CS10);
+}
+
+static inline uint32_t timer_stop(void)
+{
+	TCCR1B = 0;
+	cli();
+	uint32_t cycles = TCNT1;
+	uint32_t ovf = overflows;
+
+	// An overflow right before stopping may not have been serviced yet.
+	if (TIFR1 & _BV(TOV1))
+	{
+		TIFR1 = _BV(TOV1);
+		ovf++;
+	}
+	sei();
+	return cycles + (ovf << 16) - ovf * isr_cycles;
+}
+
+static fix16_t __attribute__((noinline)) empty_unary16(fix16_t a)
+	{ __asm__ volatile ("" : "+r" (a)); return a; }
+static fix16_t __attribute__((noinline)) empty_binary16(fix16_t a, fix16_t b)
+	{ __asm__ volatile ("" : "+r" (a) : "r" (b)); return a; }
+static fix8_t __attribute__((noinline)) empty_binary8(fix8_t a, fix8_t b)
+	{ __asm__ volatile ("" : "+r" (a) : "r" (b)); return a; }
+
+static uint32_t __attribute__((noinline)) time_unary16(fix16_unary_t fn, fix16_t a)
+{
+	timer_start();
+	sink16 = fn(a);
+	return timer_stop();
+}
+
+static uint32_t __attribute__((noinline)) time_binary16(fix16_binary_t fn, fix16_t a, fix16_t b)
+{
+	timer_start();
+	sink16 = fn(a, b);
+	return timer_stop();
+}
+
+static uint32_t __attribute__((noinline)) time_binary8(fix8_binary_t fn, fix8_t a, fix8_t b)
+{
+	timer_start();
+	sink8 = fn(a, b);
+	return timer_stop();
+}
+
+static void calibrate(void)
+{
+	// A delay of 10000 * 4 cycles fits in the timer, one of 20000 * 4 cycles
+	// forces exactly one overflow. Any excess over the expected 40000 extra
+	// cycles is the cost of the interrupt.
+	isr_cycles = 0;
+	timer_start();
+	_delay_loop_2(10000);
+	uint32_t short_delay = timer_stop();
+	timer_start();
+	_delay_loop_2(20000);
+	uint32_t long_delay = timer_stop();
+	isr_cycles = long_delay - short_delay - 40000;
+
+	overhead_unary16  = time_unary16(empty_unary16, 0);
+	overhead_binary16 = time_binary16(empty_binary16, 0, 0);
+	overhead_binary8  = time_binary8(empty_binary8, 0, 0);
+}
+
+static uint8_t hist_bucket(uint32_t cycles)
+{
+	uint8_t octave = 0;
+	if (cycles < 8)
+		return cycles;
+	while (cycles >= 16 && octave < HIST_OCTAVES - 1)
+	{
+		cycles >>= 1;
+		octave++;
+	}
+	if (cycles >= 16)
+		cycles = 15;
+	return 8 + 8 * octave + (cycles & 7);
+}
+
+// Largest value falling into the bucket.
+static uint32_t hist_upper(uint8_t bucket)
+{
+	if (bucket < 8)
+		return bucket;
+	uint8_t octave = (bucket - 8) / 8;
+	uint32_t mantissa = 8 + (bucket & 7);
+	return ((mantissa + 1) << octave) - 1;
+}
+
+// Upper bound of the given percentile, in tenths of a percent.
+static uint32_t hist_percentile(const struct stats *s, uint16_t permille)
+{
+	uint32_t target = ((uint32_t)s->count * permille + 999) / 1000;
+	uint32_t seen = 0;
+	uint8_t b;
+	for (b = 0; b < HIST_BUCKETS; b++)
+	{
+		seen += s->hist[b];
+		if (seen >= target && seen)
+			break;
+	}
+	// The bucket bound can be above the exact maximum.
+	uint32_t upper = hist_upper(b);
+	return upper < s->max ? upper : s->max;
+}
+
+static void stats_add(struct stats *s, uint32_t cycles, fix16_t a, fix16_t b)
+{
+	if (s->count == 0 || cycles < s->min) s->min = cycles;
+	if (s->count == 0 || cycles > s->max)
+	{
+		s->max = cycles;
+		s->worst_a = a;
+		s->worst_b = b;
+	}
+	s->sum += cycles;
+	s->hist[hist_bucket(cycles)]++;
+	s->count++;
+}
+
+static void report(const char *name, const struct stats *s, uint8_t arity)
+{
+	printf("%-18s %7lu %7lu %7lu %7lu %7lu %7lu %6u\n", name,
+		(unsigned long)s->min,
+		(unsigned long)((s->sum + s->count / 2) / s->count),
+		(unsigned long)hist_percentile(s, 500),
+		(unsigned long)hist_percentile(s, 990),
+		(unsigned long)hist_percentile(s, 999),
+		(unsigned long)s->max, s->count);
+	if (arity == 2)
+		printf("    worst: %s(0x%08lx, 0x%08lx)\n", name,
+			(unsigned long)s->worst_a, (unsigned long)s->worst_b);
+	else
+		printf("    worst: %s(0x%08lx)\n", name, (unsigned long)s->worst_a);
+}
+
+static void bench_unary16(const char *name, fix16_unary_t fn, uint8_t positive_only)
+{
+	uint8_t i;
+	struct stats *s = &shared_stats;
+	memset(s, 0, sizeof(*s));
+	for (i = 0; i < TESTCASES_COUNT; i++)
+	{
+		fix16_t a = testcases[i];
+		if (positive_only && a <= 0) continue;
+		stats_add(s, time_unary16(fn, a) - overhead_unary16, a, 0);
+	}
+	report(name, s, 1);
+}
+
+static void bench_binary16(const char *name, fix16_binary_t fn, uint8_t skip_zero)
+{
+	uint8_t i, j;
+	struct stats *s = &shared_stats;
+	memset(s, 0, sizeof(*s));
+	for (i = 0; i < TESTCASES_COUNT; i++)
+	{
+		for (j = 0; j < TESTCASES_COUNT; j++)
+		{
+			fix16_t a = testcases[i];
+			fix16_t b = testcases[j];
+			// We don't require a solution for /0 :)
+			if (skip_zero && b == 0) continue;
+			stats_add(s, time_binary16(fn, a, b) - overhead_binary16, a, b);
+		}
+	}
+	report(name, s, 2);
+}
+
+static void bench_binary8(const char *name, fix8_binary_t fn, uint8_t skip_zero)
+{
+	uint8_t i, j;
+	struct stats *s = &shared_stats;
+	memset(s, 0, sizeof(*s));
+	for (i = 0; i < TESTCASES8_COUNT; i++)
+	{
+		for (j = 0; j < TESTCASES8_COUNT; j++)
+		{
+			fix8_t a = testcases8[i];
+			fix8_t b = testcases8[j];
+			if (skip_zero && b == 0) continue;
+			stats_add(s, time_binary8(fn, a, b) - overhead_binary8, (uint16_t)a, (uint16_t)b);
+		}
+	}
+	report(name, s, 2);
+}
+
+/* fix16_div_by with the divider of each divisor computed before, so that
+ * only the division is timed.
+ */
+static fix16_divider_t div_by_divider;
+static fix16_t div_by16(fix16_t a) { return fix16_div_by(a, &div_by_divider); }
+
+static void bench_div_by16(const char *name)
+{
+	uint8_t i, j;
+	struct stats *s = &shared_stats;
+	memset(s, 0, sizeof(*s));
+	for (j = 0; j < TESTCASES_COUNT; j++)
+	{
+		fix16_t b = testcases[j];
+		if (b == 0) continue;
+		div_by_divider = fix16_divider(b);
+		for (i = 0; i < TESTCASES_COUNT; i++)
+		{
+			fix16_t a = testcases[i];
+			stats_add(s, time_unary16(div_by16, a) - overhead_unary16, a, b);
+		}
+	}
+	report(name, s, 2);
+}
+
+/* The add/sub functions are inlined in the header with FIXMATH_NO_OVERFLOW,
+ * so wrap them to be able to take their address.
+ */
+static fix16_t add16(fix16_t a, fix16_t b) { return fix16_add(a, b); }
+static fix16_t sub16(fix16_t a, fix16_t b) { return fix16_sub(a, b); }
+/* 1/x the old way, to compare with fix16_recip. */
+static fix16_t recip_div16(fix16_t a) { return fix16_div(fix16_one, a); }
+static fix8_t add8(fix8_t a, fix8_t b) { return fix8_add(a, b); }
+static fix8_t sub8(fix8_t a, fix8_t b) { return fix8_sub(a, b); }
+
+int main(void)
+{
+	uart_init();
+	TIMSK1 = _BV(TOIE1);
+	sei();
+
+	calibrate();
+
+	printf("\nCompiler: avr-gcc %s\n", __VERSION__);
+	printf("Cycles per call on %s at %lu Hz (ISR %u, overhead %u/%u/%u)\n",
+		AVR_MCU_NAME, (unsigned long)F_CPU, isr_cycles,
+		overhead_unary16, overhead_binary16, overhead_binary8);
+	printf("%-18s %7s %7s %7s %7s %7s %7s %6s\n", "Function",
+		"min", "avg", "p50", "p99", "p99.9", "max", "calls");
+
+	bench_binary16("fix16_mul",  fix16_mul,  0);
+	bench_binary16("fix16_div",  fix16_div,  1);
+	bench_div_by16("fix16_div_by");
+	bench_binary16("fix16_add",  add16,      0);
+	bench_binary16("fix16_sub",  sub16,      0);
+	bench_unary16 ("fix16_recip", fix16_recip, 0);
+	bench_unary16 ("fix16_recip_div", recip_div16, 0);
+	bench_unary16 ("fix16_sqrt", fix16_sqrt, 1);
+	bench_unary16 ("fix16_sin",  fix16_sin,  0);
+	bench_unary16 ("fix16_sin_parabola", fix16_sin_parabola, 0);
+	bench_unary16 ("fix16_atan", fix16_atan, 0);
+	bench_unary16 ("fix16_exp",  fix16_exp,  0);
+	bench_unary16 ("fix16_log",  fix16_log,  1);
+
+	bench_binary8 ("fix8_mul",   fix8_mul,   0);
+	bench_binary8 ("fix8_div",   fix8_div,   1);
+	bench_binary8 ("fix8_add",   add8,       0);
+	bench_binary8 ("fix8_sub",   sub8,       0);
+
+	printf("Done\n");
+	loop_until_bit_is_set(UCSR0A, TXC0);
+
+	// Sleeping with interrupts disabled makes simavr exit.
+	cli();
+	sleep_mode();
+	for (;;) {}
+}
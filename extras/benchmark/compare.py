@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""Benchmark results against a stored baseline.
+
+Reads the JSON files written by 'fix16_benchmark -j' (and by the 'avr'
+command below from the AVR benchmark output). Every result is keyed by
+function, configuration and compiler.
+
+    compare.py save <baseline> <results>...
+        merges the results into a baseline file
+    compare.py check [--threshold PCT] <baseline> <results>...
+        compares the results against the baseline and exits non-zero when
+        a function got slower by more than the threshold (default 10%)
+    compare.py avr [--config NAME] < avr-run output > results.json
+        converts the text output of the AVR benchmark
+
+Timings on the host vary from run to run, so keep the threshold well above
+the noise of the machine. The AVR cycle counts are exact.
+"""
+
+import argparse
+import json
+import re
+import sys
+
+# Metrics checked for regressions, where both sides have them. Larger is
+# worse for all of them.
+METRICS = ('fix16_ns', 'avr_cycles_avg', 'avr_cycles_max')
+
+# A row of the AVR benchmark: name, then min avg p50 p99 p99.9 max calls.
+AVR_ROW = re.compile(r'^(fix\w+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)$')
+AVR_COMPILER = re.compile(r'^Compiler: (.*)$')
+AVR_HEADER = re.compile(r'^Cycles per call on (\S+)')
+
+
+def key(result, ignore_compiler):
+    return (result['function'], result['configuration'],
+            '' if ignore_compiler else result['compiler'])
+
+
+def load(paths):
+    results = []
+    for path in paths:
+        with open(path) as f:
+            results.extend(json.load(f)['results'])
+    return results
+
+
+def save(args):
+    results = {}
+    for result in load(args.results):
+        results[key(result, False)] = result
+    with open(args.baseline, 'w') as f:
+        json.dump({'results': [results[k] for k in sorted(results)]}, f, indent=1)
+        f.write('\n')
+    print('Saved %d results to %s' % (len(results), args.baseline))
+    return 0
+
+
+def check(args):
+    baseline = {}
+    for result in load([args.baseline]):
+        baseline[key(result, args.ignore_compiler)] = result
+
+    regressions = 0
+    compared = 0
+    print('%-10s %-24s %-16s %12s %12s %8s' % ('Function', 'Configuration', 'Metric',
+                                              'baseline', 'current', 'change'))
+    for result in load(args.results):
+        old = baseline.get(key(result, args.ignore_compiler))
+        if old is None:
+            print('%-10s %-24s no baseline for %s' % (result['function'],
+                                                     result['configuration'],
+                                                     result['compiler']))
+            continue
+        for metric in METRICS:
+            if metric not in result or not old.get(metric):
+                continue
+            change = 100.0 * (result[metric] - old[metric]) / old[metric]
+            slower = change > args.threshold
+            compared += 1
+            regressions += slower
+            if slower or args.verbose:
+                print('%-10s %-24s %-16s %12.4g %12.4g %+7.1f%%%s' % (
+                    result['function'], result['configuration'], metric,
+                    old[metric], result[metric], change,
+                    '  SLOWER' if slower else ''))
+
+    print('%d of %d measurements more than %g%% slower than the baseline' %
+          (regressions, compared, args.threshold))
+    return 1 if regressions else 0
+
+
+def avr(args):
+    compiler = 'unknown'
+    config = args.config
+    results = []
+    for line in sys.stdin:
+        # simavr colours the UART output
+        line = re.sub(r'\x1b\[[0-9;]*m', '', line).strip()
+        match = AVR_COMPILER.match(line)
+        if match:
+            compiler = match.group(1)
+        match = AVR_HEADER.match(line)
+        if match and config is None:
+            config = 'avr-' + match.group(1)
+        match = AVR_ROW.match(line)
+        if match:
+            cycles = [int(v) for v in match.groups()[1:]]
+            results.append({'function': match.group(1),
+                            'avr_cycles_min': cycles[0],
+                            'avr_cycles_avg': cycles[1],
+                            'avr_cycles_p50': cycles[2],
+                            'avr_cycles_p99': cycles[3],
+                            'avr_cycles_p99.9': cycles[4],
+                            'avr_cycles_max': cycles[5]})
+    if not results:
+        sys.exit('No AVR benchmark results in the input')
+
+    for result in results:
+        result['configuration'] = config or 'avr'
+        result['compiler'] = compiler
+    json.dump({'configuration': config or 'avr', 'compiler': compiler,
+               'results': results}, sys.stdout, indent=1)
+    sys.stdout.write('\n')
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    commands = parser.add_subparsers(dest='command')
+    commands.required = True
+
+    p = commands.add_parser('save', help='merge results into a baseline')
+    p.add_argument('baseline')
+    p.add_argument('results', nargs='+')
+    p.set_defaults(func=save)
+
+    p = commands.add_parser('check', help='compare results against a baseline')
+    p.add_argument('--threshold', type=float, default=10.0,
+                   help='slowdown in percent which fails the check')
+    p.add_argument('--ignore-compiler', action='store_true',
+                   help='match results of different compilers')
+    p.add_argument('--verbose', '-v', action='store_true',
+                   help='list every measurement, not only the regressions')
+    p.add_argument('baseline')
+    p.add_argument('results', nargs='+')
+    p.set_defaults(func=check)
+
+    p = commands.add_parser('avr', help='convert the AVR benchmark output')
+    p.add_argument('--config', help='configuration name (default avr-<mcu>)')
+    p.set_defaults(func=avr)
+
+    args = parser.parse_args()
+    return args.func(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,1069 @@
+/* Host benchmark for the fix16 library.
+ *
+ * Runs the testcases[] workloads of examples/Fix16_benchmark (plus the
+ * transcendental and string functions) natively on the build machine and
+ * compares them against float and double. The library is compiled with the
+ * FIXMATH_* options given on the command line, see the Makefile in this
+ * directory, which builds one binary per configuration.
+ *
+ * With -p, hardware performance counters are read for each fix16 kernel,
+ * to show where the caches and the sine table cost more in memory traffic
+ * than they save in computation.
+ *
+ * With -l, every fix16 call is timed on its own with the cycle counter
+ * (rdtsc on x86, a nanosecond clock elsewhere) and the latency distribution
+ * is reported: percentiles, a log2 histogram and the inputs with the worst
+ * case latency, for sizing hard real-time control loops.
+ *
+ * Built with FIXMATH_PROFILE, the functions called by the mixed workload
+ * are listed by the time spent in them.
+ *
+ * Built with FIXMATH_TRACE_OVERFLOW, the call sites of the overflows in
+ * one pass of each kernel are listed.
+ *
+ * Built with FIXMATH_CACHE_STATS, the hit rates of the exp, sin and atan2
+ * caches are reported for each kernel.
+ *
+ * With -j, the results are also written to a JSON file, one record per
+ * function keyed by function, configuration and compiler, which compare.py
+ * checks against a stored baseline.
+ */
+#include <fix16.h>
+#include <fix16.hpp>
+#include <fix16_variant.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+#include <fixmath_profile.h>
+#include <fixmath_trace.h>
+#include "perf_counters.h"
+#include "testcases.h"
+
+static int      g_runs      = 5;            // Best-of-N repetitions
+static uint64_t g_min_ns    = 20000000;     // Minimum duration of one repetition
+static const char *g_filter = NULL;         // Only run kernels with this name
+static bool     g_perf      = false;        // Read hardware performance counters
+static bool     g_latency   = false;        // Per call latency distribution
+static const char *g_json   = NULL;         // Write the results to this file
+
+// Volatile sinks which the workloads assign to, to assure the compiler will
+// not remove calculation statements as they now have side-effects.
+static volatile fix16_t sink_fix16;
+static volatile float   sink_float;
+static volatile double  sink_double;
+
+static inline void consume(fix16_t v) { sink_fix16  = v; }
+static inline void consume(float v)   { sink_float  = v; }
+static inline void consume(double v)  { sink_double = v; }
+
+// Inputs, converted once up front so the conversion is not timed.
+static fix16_t in_fix16[TESTCASES_COUNT];
+static float   in_float[TESTCASES_COUNT];
+static double  in_double[TESTCASES_COUNT];
+static char    in_str[TESTCASES_COUNT][16];
+
+/* Inputs of the mixed workload: slowly varying angles and exponents, as a
+ * stream of sensor readings would produce, rather than the testcases[]
+ * extremes. Enough of them that the caches see a realistic mix of hits,
+ * misses and evictions.
+ */
+#define MIXED_COUNT (16384)
+static fix16_t mixed_fix16[MIXED_COUNT];
+static float   mixed_float[MIXED_COUNT];
+static double  mixed_double[MIXED_COUNT];
+
+template<typename T> static const T *inputs();
+template<> const fix16_t *inputs<fix16_t>() { return in_fix16;  }
+template<> const float   *inputs<float>()   { return in_float;  }
+template<> const double  *inputs<double>()  { return in_double; }
+
+template<typename T> static const T *mixed_inputs();
+template<> const fix16_t *mixed_inputs<fix16_t>() { return mixed_fix16;  }
+template<> const float   *mixed_inputs<float>()   { return mixed_float;  }
+template<> const double  *mixed_inputs<double>()  { return mixed_double; }
+
+static void init_inputs( void )
+{
+  for (unsigned i = 0; i < TESTCASES_COUNT; i++)
+  {
+    in_fix16[i]  = testcases[i];
+    in_float[i]  = fix16_to_float(testcases[i]);
+    in_double[i] = fix16_to_dbl(testcases[i]);
+    fix16_to_str(testcases[i], in_str[i], 5);
+  }
+
+  // Random walk in [-4, 4], with steps of up to 1/64.
+  uint32_t seed = 12345;
+  fix16_t x = 0;
+  for (unsigned i = 0; i < MIXED_COUNT; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    x += (fix16_t)((seed >> 16) & 0x7FF) - 0x400;
+    x = fix16_clamp(x, fix16_from_int(-4), fix16_from_int(4));
+    mixed_fix16[i]  = x;
+    mixed_float[i]  = fix16_to_float(x);
+    mixed_double[i] = fix16_to_dbl(x);
+  }
+}
+
+static uint64_t now_ns( void )
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/* Timestamps around a single call. The fences keep the CPU from executing
+ * the call before the first or after the second timestamp is taken.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TICKS_UNIT "TSC ticks"
+static inline uint64_t ticks_begin( void )
+{
+  _mm_lfence();
+  uint64_t t = __rdtsc();
+  _mm_lfence();
+  return t;
+}
+static inline uint64_t ticks_end( void )
+{
+  unsigned aux;
+  uint64_t t = __rdtscp(&aux);
+  _mm_lfence();
+  return t;
+}
+#else
+#define TICKS_UNIT "ns"
+static inline uint64_t ticks_begin( void ) { return now_ns(); }
+static inline uint64_t ticks_end( void )   { return now_ns(); }
+#endif
+
+// Hides a value from the optimizer, so the call depending on it cannot be
+// moved in front of the first timestamp, nor its result used after the
+// second one.
+#define OPAQUE(x) __asm__ volatile ("" : "+r" (x))
+
+/* Operations. Each one has a fix16 implementation and a generic one which
+ * is instantiated for float and double. skip() filters out inputs the
+ * operation is not defined for, as examples/Fix16_benchmark does for /0.
+ */
+struct OpMul   { static fix16_t fix(fix16_t a, fix16_t b) { return fix16_mul(a, b); }
+                 template<typename T> static T real(T a, T b) { return a * b; }
+                 template<typename T> static bool skip(T, T) { return false; } };
+struct OpMulNr { static fix16_t fix(fix16_t a, fix16_t b) { return fix16_nr_mul(a, b); }
+                 template<typename T> static T real(T a, T b) { return a * b; }
+                 template<typename T> static bool skip(T, T) { return false; } };
+struct OpMulNo { static fix16_t fix(fix16_t a, fix16_t b) { return fix16_no_mul(a, b); }
+                 template<typename T> static T real(T a, T b) { return a * b; }
+                 template<typename T> static bool skip(T, T) { return false; } };
+/* a*b + b*b - a with Fix16 operators, and fused into one rounding, see
+ * fixmath_fused.hpp. */
+struct OpExpr  { static fix16_t fix(fix16_t a, fix16_t b) { Fix16 x(a), y(b); return x * y + y * y - x; }
+                 template<typename T> static T real(T a, T b) { return a * b + b * b - a; }
+                 template<typename T> static bool skip(T, T) { return false; } };
+struct OpExprFused { static fix16_t fix(fix16_t a, fix16_t b) { Fix16 x(a), y(b), r = fused(x) * y + fused(y) * y - x; return r; }
+                 template<typename T> static T real(T a, T b) { return a * b + b * b - a; }
+                 template<typename T> static bool skip(T, T) { return false; } };
+struct OpDiv   { static fix16_t fix(fix16_t a, fix16_t b) { return fix16_div(a, b); }
+                 template<typename T> static T real(T a, T b) { return a / b; }
+                 template<typename T> static bool skip(T, T b) { return b == 0; } };
+struct OpAdd   { static fix16_t fix(fix16_t a, fix16_t b) { return fix16_add(a, b); }
+                 template<typename T> static T real(T a, T b) { return a + b; }
+                 template<typename T> static bool skip(T, T) { return false; } };
+struct OpSub   { static fix16_t fix(fix16_t a, fix16_t b) { return fix16_sub(a, b); }
+                 template<typename T> static T real(T a, T b) { return a - b; }
+                 template<typename T> static bool skip(T, T) { return false; } };
+#ifndef FIXMATH_NO_OVERFLOW
+struct OpSmul  { static fix16_t fix(fix16_t a, fix16_t b) { return fix16_smul(a, b); }
+                 template<typename T> static T real(T a, T b) { return a * b; }
+                 template<typename T> static bool skip(T, T) { return false; } };
+struct OpSadd  { static fix16_t fix(fix16_t a, fix16_t b) { return fix16_sadd(a, b); }
+                 template<typename T> static T real(T a, T b) { return a + b; }
+                 template<typename T> static bool skip(T, T) { return false; } };
+#endif
+struct OpAtan2 { static fix16_t fix(fix16_t a, fix16_t b) { return fix16_atan2(a, b); }
+                 static float  real(float a, float b)   { return atan2f(a, b); }
+                 static double real(double a, double b) { return atan2(a, b); }
+                 template<typename T> static bool skip(T, T) { return false; } };
+
+struct OpSqrt  { static fix16_t fix(fix16_t a) { return fix16_sqrt(a); }
+                 static float  real(float a)  { return sqrtf(a); }
+                 static double real(double a) { return sqrt(a); }
+                 template<typename T> static bool skip(T a) { return a < 0; } };
+struct OpRecip { static fix16_t fix(fix16_t a) { return fix16_recip(a); }
+                 template<typename T> static T real(T a) { return 1 / a; }
+                 template<typename T> static bool skip(T a) { return a == 0; } };
+struct OpRecipDiv { static fix16_t fix(fix16_t a) { return fix16_div(fix16_one, a); }
+                 template<typename T> static T real(T a) { return 1 / a; }
+                 template<typename T> static bool skip(T a) { return a == 0; } };
+struct OpSin   { static fix16_t fix(fix16_t a) { return fix16_sin(a); }
+                 static float  real(float a)  { return sinf(a); }
+                 static double real(double a) { return sin(a); }
+                 template<typename T> static bool skip(T) { return false; } };
+struct OpCos   { static fix16_t fix(fix16_t a) { return fix16_cos(a); }
+                 static float  real(float a)  { return cosf(a); }
+                 static double real(double a) { return cos(a); }
+                 template<typename T> static bool skip(T) { return false; } };
+struct OpExp   { static fix16_t fix(fix16_t a) { return fix16_exp(a); }
+                 static float  real(float a)  { return expf(a); }
+                 static double real(double a) { return exp(a); }
+                 template<typename T> static bool skip(T) { return false; } };
+struct OpLog   { static fix16_t fix(fix16_t a) { return fix16_log(a); }
+                 static float  real(float a)  { return logf(a); }
+                 static double real(double a) { return log(a); }
+                 template<typename T> static bool skip(T a) { return a <= 0; } };
+struct OpLog2  { static fix16_t fix(fix16_t a) { return fix16_log2(a); }
+                 static float  real(float a)  { return log2f(a); }
+                 static double real(double a) { return log2(a); }
+                 template<typename T> static bool skip(T a) { return a <= 0; } };
+
+/* Workloads. Each runs the operation over the whole testcase set once
+ * and returns the number of operations performed.
+ */
+template<class Op> static unsigned binary_fix16( void )
+{
+  const fix16_t *in = inputs<fix16_t>();
+  unsigned i, j, ops = 0;
+  for (i = 0; i < TESTCASES_COUNT; i++)
+  {
+    for (j = 0; j < TESTCASES_COUNT; j++)
+    {
+      fix16_t a = in[i];
+      fix16_t b = in[j];
+      if (Op::skip(a, b)) continue;
+      consume(Op::fix(a, b));
+      ops++;
+    }
+  }
+  return ops;
+}
+
+template<class Op, typename T> static unsigned binary_real( void )
+{
+  const T *in = inputs<T>();
+  unsigned i, j, ops = 0;
+  for (i = 0; i < TESTCASES_COUNT; i++)
+  {
+    for (j = 0; j < TESTCASES_COUNT; j++)
+    {
+      T a = in[i];
+      T b = in[j];
+      if (Op::skip(a, b)) continue;
+      consume(Op::real(a, b));
+      ops++;
+    }
+  }
+  return ops;
+}
+
+template<class Op> static unsigned unary_fix16( void )
+{
+  const fix16_t *in = inputs<fix16_t>();
+  unsigned i, ops = 0;
+  for (i = 0; i < TESTCASES_COUNT; i++)
+  {
+    fix16_t a = in[i];
+    if (Op::skip(a)) continue;
+    consume(Op::fix(a));
+    ops++;
+  }
+  return ops;
+}
+
+template<class Op, typename T> static unsigned unary_real( void )
+{
+  const T *in = inputs<T>();
+  unsigned i, ops = 0;
+  for (i = 0; i < TESTCASES_COUNT; i++)
+  {
+    T a = in[i];
+    if (Op::skip(a)) continue;
+    consume(Op::real(a));
+    ops++;
+  }
+  return ops;
+}
+
+static unsigned to_str_fix16( void )
+{
+  char buf[16];
+  for (unsigned i = 0; i < TESTCASES_COUNT; i++)
+  {
+    fix16_to_str(in_fix16[i], buf, 5);
+    consume((fix16_t)buf[0]);
+  }
+  return TESTCASES_COUNT;
+}
+
+template<typename T> static unsigned to_str_real( void )
+{
+  const T *in = inputs<T>();
+  char buf[64];
+  for (unsigned i = 0; i < TESTCASES_COUNT; i++)
+  {
+    snprintf(buf, sizeof(buf), "%.5f", (double)in[i]);
+    consume((T)buf[0]);
+  }
+  return TESTCASES_COUNT;
+}
+
+static unsigned from_str_fix16( void )
+{
+  for (unsigned i = 0; i < TESTCASES_COUNT; i++)
+    consume(fix16_from_str(in_str[i]));
+  return TESTCASES_COUNT;
+}
+
+static unsigned from_str_float( void )
+{
+  for (unsigned i = 0; i < TESTCASES_COUNT; i++)
+    consume(strtof(in_str[i], NULL));
+  return TESTCASES_COUNT;
+}
+
+static unsigned from_str_double( void )
+{
+  for (unsigned i = 0; i < TESTCASES_COUNT; i++)
+    consume(strtod(in_str[i], NULL));
+  return TESTCASES_COUNT;
+}
+
+/* Division of all inputs by one divisor at a time, through a precomputed
+ * fix16_divider_t. Same operations as the div kernel, in the other order.
+ */
+static unsigned div_by_fix16( void )
+{
+  const fix16_t *in = inputs<fix16_t>();
+  unsigned i, j, ops = 0;
+  for (j = 0; j < TESTCASES_COUNT; j++)
+  {
+    if (in[j] == 0) continue;
+    fix16_divider_t divider = fix16_divider(in[j]);
+    for (i = 0; i < TESTCASES_COUNT; i++)
+    {
+      consume(fix16_div_by(in[i], &divider));
+      ops++;
+    }
+  }
+  return ops;
+}
+
+template<typename T> static unsigned div_by_real( void )
+{
+  const T *in = inputs<T>();
+  unsigned i, j, ops = 0;
+  for (j = 0; j < TESTCASES_COUNT; j++)
+  {
+    if (in[j] == 0) continue;
+    for (i = 0; i < TESTCASES_COUNT; i++)
+    {
+      consume(in[i] / in[j]);
+      ops++;
+    }
+  }
+  return ops;
+}
+
+/* Division of all inputs by divisors of 16.0 and above, e.g. sample counts,
+ * with fix16_div or through a fix16_divider_t. The divider only gains where
+ * fix16_div rounds exactly, see fix16_divider().
+ */
+static const fix16_t big_divisors[] = {
+  F16(16), F16(-60), F16(100), F16(1000), F16(3600), F16(-12345.5)
+};
+#define BIG_DIVISORS_COUNT (sizeof(big_divisors)/sizeof(big_divisors[0]))
+
+template<bool By> static unsigned div_big_fix16( void )
+{
+  const fix16_t *in = inputs<fix16_t>();
+  unsigned i, j;
+  for (j = 0; j < BIG_DIVISORS_COUNT; j++)
+  {
+    fix16_divider_t divider = fix16_divider(big_divisors[j]);
+    for (i = 0; i < TESTCASES_COUNT; i++)
+      consume(By ? fix16_div_by(in[i], &divider) : fix16_div(in[i], big_divisors[j]));
+  }
+  return BIG_DIVISORS_COUNT * TESTCASES_COUNT;
+}
+
+template<typename T> static unsigned div_big_real( void )
+{
+  const T *in = inputs<T>();
+  unsigned i, j;
+  for (j = 0; j < BIG_DIVISORS_COUNT; j++)
+  {
+    T divisor = (T)fix16_to_dbl(big_divisors[j]);
+    for (i = 0; i < TESTCASES_COUNT; i++)
+      consume(in[i] / divisor);
+  }
+  return BIG_DIVISORS_COUNT * TESTCASES_COUNT;
+}
+
+/* 64 tap FIR filter over the mixed inputs, with coefficients in [-0.5, 0.5].
+ * fir_mac sums each output in a fix16_acc_t and rounds once, fir_mul rounds
+ * and checks every term with fix16_mul and fix16_add.
+ */
+#define FIR_TAPS 64
+
+template<typename T> static const T *fir_coeffs()
+{
+  static T coeffs[FIR_TAPS];
+  const T *in = mixed_inputs<T>();
+  for (unsigned i = 0; i < FIR_TAPS; i++)
+    coeffs[i] = in[i * 97] / 8;
+  return coeffs;
+}
+
+static unsigned fir_mac_fix16( void )
+{
+  const fix16_t *in = mixed_inputs<fix16_t>();
+  const fix16_t *coeffs = fir_coeffs<fix16_t>();
+  for (unsigned i = 0; i + FIR_TAPS <= MIXED_COUNT; i++)
+  {
+    fix16_acc_t acc = fix16_acc_init(0);
+    for (unsigned j = 0; j < FIR_TAPS; j++)
+      acc = fix16_mac(acc, coeffs[j], in[i + j]);
+    consume(fix16_acc_result(acc));
+  }
+  return (MIXED_COUNT - FIR_TAPS + 1) * FIR_TAPS;
+}
+
+static unsigned fir_mul_fix16( void )
+{
+  const fix16_t *in = mixed_inputs<fix16_t>();
+  const fix16_t *coeffs = fir_coeffs<fix16_t>();
+  for (unsigned i = 0; i + FIR_TAPS <= MIXED_COUNT; i++)
+  {
+    fix16_t sum = 0;
+    for (unsigned j = 0; j < FIR_TAPS; j++)
+      sum = fix16_add(sum, fix16_mul(coeffs[j], in[i + j]));
+    consume(sum);
+  }
+  return (MIXED_COUNT - FIR_TAPS + 1) * FIR_TAPS;
+}
+
+template<typename T> static unsigned fir_real( void )
+{
+  const T *in = mixed_inputs<T>();
+  const T *coeffs = fir_coeffs<T>();
+  for (unsigned i = 0; i + FIR_TAPS <= MIXED_COUNT; i++)
+  {
+    T sum = 0;
+    for (unsigned j = 0; j < FIR_TAPS; j++)
+      sum += coeffs[j] * in[i + j];
+    consume(sum);
+  }
+  return (MIXED_COUNT - FIR_TAPS + 1) * FIR_TAPS;
+}
+
+/* Mixed workload: exp, sin and atan2 interleaved on the sensor-like
+ * inputs, i.e. all three caches (or the sine table) in use at once.
+ */
+static unsigned mixed_fix16_workload( void )
+{
+  const fix16_t *in = mixed_inputs<fix16_t>();
+  for (unsigned i = 0; i < MIXED_COUNT; i++)
+  {
+    fix16_t x = in[i];
+    fix16_t y = in[(i + MIXED_COUNT / 2) % MIXED_COUNT];
+    consume(fix16_exp(x));
+    consume(fix16_sin(x));
+    consume(fix16_atan2(y, x));
+  }
+  return 3 * MIXED_COUNT;
+}
+
+template<typename T> static unsigned mixed_real_workload( void )
+{
+  const T *in = mixed_inputs<T>();
+  for (unsigned i = 0; i < MIXED_COUNT; i++)
+  {
+    T x = in[i];
+    T y = in[(i + MIXED_COUNT / 2) % MIXED_COUNT];
+    consume(OpExp::real(x));
+    consume(OpSin::real(x));
+    consume(OpAtan2::real(y, x));
+  }
+  return 3 * MIXED_COUNT;
+}
+
+/* Latency samples. Each one is a single timed call and its inputs. */
+struct Sample
+{
+  uint32_t ticks;
+  fix16_t  a, b;
+};
+
+typedef std::vector<Sample> Samples;
+
+static inline void record(Samples &out, uint64_t t0, uint64_t t1, fix16_t a, fix16_t b)
+{
+  Sample s = { (uint32_t)(t1 - t0), a, b };
+  out.push_back(s);
+}
+
+template<class Op> static void latency_binary(Samples &out)
+{
+  const fix16_t *in = inputs<fix16_t>();
+  for (unsigned i = 0; i < TESTCASES_COUNT; i++)
+  {
+    for (unsigned j = 0; j < TESTCASES_COUNT; j++)
+    {
+      fix16_t a = in[i], b = in[j];
+      if (Op::skip(a, b)) continue;
+      uint64_t t0 = ticks_begin();
+      OPAQUE(a); OPAQUE(b);
+      fix16_t r = Op::fix(a, b);
+      OPAQUE(r);
+      uint64_t t1 = ticks_end();
+      consume(r);
+      record(out, t0, t1, in[i], in[j]);
+    }
+  }
+}
+
+template<class Op> static void latency_unary(Samples &out)
+{
+  const fix16_t *in = inputs<fix16_t>();
+  for (unsigned i = 0; i < TESTCASES_COUNT; i++)
+  {
+    fix16_t a = in[i];
+    if (Op::skip(a)) continue;
+    uint64_t t0 = ticks_begin();
+    OPAQUE(a);
+    fix16_t r = Op::fix(a);
+    OPAQUE(r);
+    uint64_t t1 = ticks_end();
+    consume(r);
+    record(out, t0, t1, in[i], 0);
+  }
+}
+
+static void latency_to_str(Samples &out)
+{
+  char buf[16];
+  for (unsigned i = 0; i < TESTCASES_COUNT; i++)
+  {
+    fix16_t a = in_fix16[i];
+    uint64_t t0 = ticks_begin();
+    OPAQUE(a);
+    fix16_to_str(a, buf, 5);
+    uint64_t t1 = ticks_end();
+    consume((fix16_t)buf[0]);
+    record(out, t0, t1, in_fix16[i], 0);
+  }
+}
+
+static void latency_from_str(Samples &out)
+{
+  for (unsigned i = 0; i < TESTCASES_COUNT; i++)
+  {
+    const char *str = in_str[i];
+    uint64_t t0 = ticks_begin();
+    OPAQUE(str);
+    fix16_t r = fix16_from_str(str);
+    OPAQUE(r);
+    uint64_t t1 = ticks_end();
+    consume(r);
+    record(out, t0, t1, in_fix16[i], 0);
+  }
+}
+
+typedef unsigned (*workload_t)( void );
+typedef void (*latency_t)(Samples &out);
+
+struct Kernel
+{
+  const char *name;
+  workload_t  fix16;
+  workload_t  flt;
+  workload_t  dbl;
+  latency_t   latency;  // NULL if the kernel has no single call to time
+  unsigned    arity;    // Number of fix16_t inputs of the timed call
+};
+
+#define BINARY_KERNEL(name, op) \
+  { name, binary_fix16<op>, binary_real<op, float>, binary_real<op, double>, latency_binary<op>, 2 }
+#define UNARY_KERNEL(name, op) \
+  { name, unary_fix16<op>, unary_real<op, float>, unary_real<op, double>, latency_unary<op>, 1 }
+
+static const Kernel kernels[] = {
+  BINARY_KERNEL("mul",   OpMul),
+  BINARY_KERNEL("mul_nr", OpMulNr),
+  BINARY_KERNEL("mul_no", OpMulNo),
+  BINARY_KERNEL("expr",  OpExpr),
+  BINARY_KERNEL("expr_fused", OpExprFused),
+  BINARY_KERNEL("div",   OpDiv),
+  { "div_by",     div_by_fix16,   div_by_real<float>, div_by_real<double>, NULL, 0 },
+  { "div_big",    div_big_fix16<false>, div_big_real<float>, div_big_real<double>, NULL, 0 },
+  { "div_by_big", div_big_fix16<true>,  div_big_real<float>, div_big_real<double>, NULL, 0 },
+  BINARY_KERNEL("add",   OpAdd),
+  BINARY_KERNEL("sub",   OpSub),
+#ifndef FIXMATH_NO_OVERFLOW
+  BINARY_KERNEL("smul",  OpSmul),
+  BINARY_KERNEL("sadd",  OpSadd),
+#endif
+  UNARY_KERNEL ("recip", OpRecip),
+  UNARY_KERNEL ("recip_div", OpRecipDiv),
+  UNARY_KERNEL ("sqrt",  OpSqrt),
+  UNARY_KERNEL ("sin",   OpSin),
+  UNARY_KERNEL ("cos",   OpCos),
+  BINARY_KERNEL("atan2", OpAtan2),
+  UNARY_KERNEL ("exp",   OpExp),
+  UNARY_KERNEL ("log",   OpLog),
+  UNARY_KERNEL ("log2",  OpLog2),
+  { "to_str",   to_str_fix16,   to_str_real<float>, to_str_real<double>, latency_to_str,   1 },
+  { "from_str", from_str_fix16, from_str_float,     from_str_double,     latency_from_str, 1 },
+  { "fir_mac",  fir_mac_fix16,  fir_real<float>,   fir_real<double>,   NULL, 0 },
+  { "fir_mul",  fir_mul_fix16,  fir_real<float>,   fir_real<double>,   NULL, 0 },
+  { "mixed",    mixed_fix16_workload, mixed_real_workload<float>, mixed_real_workload<double>, NULL, 0 },
+};
+
+#define KERNELS_COUNT (sizeof(kernels)/sizeof(kernels[0]))
+
+/* Returns the best time per operation out of g_runs repetitions.
+ * Each repetition loops over the workload for at least g_min_ns.
+ */
+static double measure(workload_t workload)
+{
+  double best = 0;
+  workload(); // Warm up caches, both the CPU's and the library's
+
+  for (int r = 0; r < g_runs; r++)
+  {
+    unsigned long ops = 0;
+    uint64_t t0 = now_ns(), t1;
+    do
+    {
+      ops += workload();
+      t1 = now_ns();
+    } while (t1 - t0 < g_min_ns);
+
+    double ns = (double)(t1 - t0) / ops;
+    if (r == 0 || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+/* Runs the workload for g_min_ns with the counters enabled and stores the
+ * counts per operation in per_op.
+ */
+static void count_events(workload_t workload, struct perf_counters *pc,
+                         double per_op[PERF_COUNTERS_COUNT])
+{
+  unsigned long ops = 0;
+  workload();
+
+  uint64_t t0 = now_ns();
+  perf_counters_start(pc);
+  do
+  {
+    ops += workload();
+  } while (now_ns() - t0 < g_min_ns);
+  perf_counters_stop(pc);
+
+  for (int i = 0; i < PERF_COUNTERS_COUNT; i++)
+    per_op[i] = (double)pc->value[i] / ops;
+}
+
+/* Results of one kernel, for the JSON output. Fields which were not
+ * measured are left negative.
+ */
+struct Result
+{
+  const char *function;
+  double ns_fix16, ns_float, ns_double;
+  double perf[PERF_COUNTERS_COUNT];
+  double latency[5]; // min, p50, p99, p99.9, max
+};
+
+static const char *const latency_names[5] = { "min", "p50", "p99", "p99.9", "max" };
+
+static std::vector<Result> g_results;
+
+static Result &result_for(const char *function)
+{
+  for (size_t i = 0; i < g_results.size(); i++)
+  {
+    if (!strcmp(g_results[i].function, function))
+      return g_results[i];
+  }
+  Result r;
+  r.function = function;
+  r.ns_fix16 = r.ns_float = r.ns_double = -1;
+  for (int i = 0; i < PERF_COUNTERS_COUNT; i++) r.perf[i] = -1;
+  for (int i = 0; i < 5; i++) r.latency[i] = -1;
+  g_results.push_back(r);
+  return g_results.back();
+}
+
+static const char *compiler_name( void )
+{
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#else
+  return "unknown";
+#endif
+}
+
+static uint32_t percentile(const std::vector<uint32_t> &sorted, double p)
+{
+  size_t i = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+  return sorted[i];
+}
+
+// Cost of the timing itself: the fastest of many empty measurements.
+static uint32_t latency_overhead( void )
+{
+  uint32_t best = UINT32_MAX;
+  for (int i = 0; i < 100000; i++)
+  {
+    fix16_t r = 0;
+    uint64_t t0 = ticks_begin();
+    OPAQUE(r);
+    uint64_t t1 = ticks_end();
+    if (t1 - t0 < best)
+      best = t1 - t0;
+  }
+  return best;
+}
+
+/* Times every call of the kernel in g_runs passes over its inputs and
+ * prints the distribution. The worst case inputs are ranked by their
+ * fastest pass, so that a single interrupt or cache miss on the host does
+ * not make an input look slow.
+ */
+static void report_latency(const Kernel &kernel, uint32_t overhead)
+{
+  Samples samples;
+  kernel.latency(samples);     // Warm up
+  size_t per_pass = samples.size();
+  samples.clear();
+  for (int r = 0; r < g_runs; r++)
+    kernel.latency(samples);
+
+  std::vector<uint32_t> ticks(samples.size());
+  std::vector<Sample> best(samples.begin(), samples.begin() + per_pass);
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    Sample &s = samples[i];
+    s.ticks = (s.ticks > overhead) ? s.ticks - overhead : 0;
+    ticks[i] = s.ticks;
+    if (s.ticks < best[i % per_pass].ticks || i < per_pass)
+      best[i % per_pass].ticks = s.ticks;
+  }
+  std::sort(ticks.begin(), ticks.end());
+
+  double *latency = result_for(kernel.name).latency;
+  latency[0] = ticks.front();
+  latency[1] = percentile(ticks, 50);
+  latency[2] = percentile(ticks, 99);
+  latency[3] = percentile(ticks, 99.9);
+  latency[4] = ticks.back();
+  printf("%-9s %9u %7u %7u %7u %7u %7u\n", kernel.name, (unsigned)ticks.size(),
+         ticks.front(), percentile(ticks, 50), percentile(ticks, 99),
+         percentile(ticks, 99.9), ticks.back());
+
+  // Histogram with power of two buckets
+  printf("          histogram:");
+  size_t i = 0;
+  for (uint32_t lo = 0, hi = 1; i < ticks.size(); lo = hi, hi <<= 1)
+  {
+    size_t n = 0;
+    while (i < ticks.size() && ticks[i] < hi) { i++; n++; }
+    if (n)
+      printf(" [%u,%u):%u", lo, hi, (unsigned)n);
+  }
+  printf("\n");
+
+  std::sort(best.begin(), best.end(),
+            [](const Sample &x, const Sample &y) { return x.ticks > y.ticks; });
+  for (size_t w = 0; w < 3 && w < best.size(); w++)
+  {
+    if (kernel.arity == 2)
+      printf("          worst: %s(0x%08x, 0x%08x) %u\n", kernel.name,
+             (uint32_t)best[w].a, (uint32_t)best[w].b, best[w].ticks);
+    else
+      printf("          worst: %s(0x%08x) %u\n", kernel.name,
+             (uint32_t)best[w].a, best[w].ticks);
+  }
+}
+
+static const char *config_name( void )
+{
+  static char name[128];
+  name[0] = '\0';
+#ifdef FIXMATH_NO_64BIT
+  strcat(name, "NO_64BIT ");
+#endif
+#ifdef FIXMATH_OPTIMIZE_8BIT
+  strcat(name, "OPTIMIZE_8BIT ");
+#endif
+#ifdef FIXMATH_NO_CACHE
+  strcat(name, "NO_CACHE ");
+#endif
+#ifdef FIXMATH_SIN_LUT
+  strcat(name, "SIN_LUT ");
+#endif
+#ifdef FIXMATH_FAST_SIN
+  strcat(name, "FAST_SIN ");
+#endif
+#ifdef FIXMATH_NO_ROUNDING
+  strcat(name, "NO_ROUNDING ");
+#endif
+#ifdef FIXMATH_NO_OVERFLOW
+  strcat(name, "NO_OVERFLOW ");
+#endif
+#ifdef FIXMATH_INLINE
+  strcat(name, "INLINE ");
+#endif
+#ifdef FIXMATH_DIV64
+  strcat(name, "DIV64 ");
+#endif
+#ifdef FIXMATH_STICKY_OVERFLOW
+  strcat(name, "STICKY_OVERFLOW ");
+#endif
+  size_t len = strlen(name);
+  if (len == 0)
+    strcpy(name, "default");
+  else
+    name[len - 1] = '\0';
+  return name;
+}
+
+// Appends a field to the current record, unless it was not measured.
+static void json_number(FILE *f, const char *name, double value)
+{
+  if (value >= 0)
+    fprintf(f, ", \"%s\": %.6g", name, value);
+}
+
+static bool write_json(const char *path)
+{
+  FILE *f = fopen(path, "w");
+  if (!f)
+  {
+    perror(path);
+    return false;
+  }
+
+  fprintf(f, "{\n  \"configuration\": \"%s\",\n  \"compiler\": \"%s\",\n"
+             "  \"latency_unit\": \"" TICKS_UNIT "\",\n  \"results\": [",
+          config_name(), compiler_name());
+  for (size_t i = 0; i < g_results.size(); i++)
+  {
+    const Result &r = g_results[i];
+    fprintf(f, "%s\n    { \"function\": \"%s\", \"configuration\": \"%s\", \"compiler\": \"%s\"",
+            i ? "," : "", r.function, config_name(), compiler_name());
+    json_number(f, "fix16_ns", r.ns_fix16);
+    json_number(f, "float_ns", r.ns_float);
+    json_number(f, "double_ns", r.ns_double);
+    for (int c = 0; c < PERF_COUNTERS_COUNT; c++)
+      json_number(f, perf_counter_names[c], r.perf[c]);
+    for (int l = 0; l < 5; l++)
+    {
+      char name[32];
+      snprintf(name, sizeof(name), "latency_%s", latency_names[l]);
+      json_number(f, name, r.latency[l]);
+    }
+    fprintf(f, " }");
+  }
+  fprintf(f, "\n  ]\n}\n");
+  return fclose(f) == 0;
+}
+
+#if defined(FIXMATH_CACHE_STATS) && !defined(FIXMATH_NO_CACHE)
+/* Runs the kernel once over its inputs, after one warm up pass, and prints
+ * the use of the caches it touched.
+ */
+static void report_cache_stats(const Kernel &kernel)
+{
+  static const char *const names[FIX16_CACHE_COUNT] = { "exp", "sin", "atan2" };
+  kernel.fix16();
+  fix16_cache_stats_reset();
+  kernel.fix16();
+
+  for (int c = 0; c < FIX16_CACHE_COUNT; c++)
+  {
+    fix16_cache_stats_t stats;
+    fix16_cache_stats((fix16_cache_t)c, &stats);
+    if (!stats.lookups)
+      continue;
+    printf("%-9s %-6s %10u %9.1f%% %10u %10u\n", kernel.name, names[c],
+           (unsigned)stats.lookups, 100.0 * stats.hits / stats.lookups,
+           (unsigned)stats.collisions, (unsigned)stats.evictions);
+  }
+}
+#endif
+
+#if defined(FIXMATH_PROFILE) || defined(FIXMATH_TRACE_OVERFLOW)
+static void print_line(const char *line)
+{
+  puts(line);
+}
+#endif
+
+static void usage(const char *argv0)
+{
+  fprintf(stderr,
+    "Usage: %s [-r runs] [-t min_ms] [-k kernel] [-p] [-l] [-j file]\n"
+    "  -r runs    best-of-N repetitions per measurement (default %d)\n"
+    "  -t min_ms  minimum duration of a repetition in ms (default %u)\n"
+    "  -k kernel  only run the named kernel\n"
+    "  -p         read hardware performance counters for the fix16 kernels\n"
+    "  -l         per call latency distribution of the fix16 kernels\n"
+    "  -j file    also write the results as JSON to file\n",
+    argv0, g_runs, (unsigned)(g_min_ns / 1000000));
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "-r") && i + 1 < argc)
+      g_runs = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+      g_min_ns = (uint64_t)atoi(argv[++i]) * 1000000;
+    else if (!strcmp(argv[i], "-k") && i + 1 < argc)
+      g_filter = argv[++i];
+    else if (!strcmp(argv[i], "-p"))
+      g_perf = true;
+    else if (!strcmp(argv[i], "-l"))
+      g_latency = true;
+    else if (!strcmp(argv[i], "-j") && i + 1 < argc)
+      g_json = argv[++i];
+    else
+    {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (g_runs < 1)
+    g_runs = 1;
+
+  init_inputs();
+
+  struct perf_counters pc = perf_counters();
+  if (g_perf && perf_counters_open(&pc) == 0)
+  {
+    fprintf(stderr, "No performance counters available, see perf_event_paranoid\n");
+    g_perf = false;
+  }
+
+  printf("Configuration: %s\n", config_name());
+  printf("%-9s %12s %12s %12s %12s %9s %9s\n",
+         "Op", "fix16 ns/op", "fix16 ops/s", "float ns/op", "double ns/op",
+         "vs float", "vs double");
+
+  for (unsigned k = 0; k < KERNELS_COUNT; k++)
+  {
+    const Kernel &kernel = kernels[k];
+    if (g_filter && strcmp(g_filter, kernel.name))
+      continue;
+
+    double ns_fix16  = measure(kernel.fix16);
+    double ns_float  = measure(kernel.flt);
+    double ns_double = measure(kernel.dbl);
+
+    Result &result = result_for(kernel.name);
+    result.ns_fix16  = ns_fix16;
+    result.ns_float  = ns_float;
+    result.ns_double = ns_double;
+
+    printf("%-9s %12.2f %12.4g %12.2f %12.2f %8.2fx %8.2fx\n",
+           kernel.name, ns_fix16, 1e9 / ns_fix16, ns_float, ns_double,
+           ns_float / ns_fix16, ns_double / ns_fix16);
+  }
+
+#ifdef FIXMATH_PROFILE
+  printf("\nProfile of one pass of the mixed workload\n");
+  fixmath_profile_reset();
+  mixed_fix16_workload();
+  fixmath_profile_dump(print_line, 10);
+#endif
+
+#if defined(FIXMATH_TRACE_OVERFLOW) && !defined(FIXMATH_NO_OVERFLOW)
+  printf("\nOverflows in one pass of each kernel (addr2line -f -C -e <binary> <site>)\n");
+  fixmath_trace_reset();
+  for (unsigned k = 0; k < KERNELS_COUNT; k++)
+  {
+    if (!g_filter || !strcmp(g_filter, kernels[k].name))
+      kernels[k].fix16();
+  }
+  fixmath_trace_dump(print_line);
+#endif
+
+#if defined(FIXMATH_CACHE_STATS) && !defined(FIXMATH_NO_CACHE)
+  printf("\nCache use in the second pass over the inputs\n");
+  printf("%-9s %-6s %10s %10s %10s %10s\n",
+         "Op", "Cache", "lookups", "hit rate", "collisions", "evictions");
+  for (unsigned k = 0; k < KERNELS_COUNT; k++)
+  {
+    if (!g_filter || !strcmp(g_filter, kernels[k].name))
+      report_cache_stats(kernels[k]);
+  }
+#endif
+
+  if (g_perf)
+  {
+    printf("\nPerformance counters per fix16 operation\n");
+    printf("%-9s", "Op");
+    for (int i = 0; i < PERF_COUNTERS_COUNT; i++)
+      printf(" %13s", perf_counter_names[i]);
+    printf("\n");
+
+    for (unsigned k = 0; k < KERNELS_COUNT; k++)
+    {
+      const Kernel &kernel = kernels[k];
+      if (g_filter && strcmp(g_filter, kernel.name))
+        continue;
+
+      double per_op[PERF_COUNTERS_COUNT];
+      count_events(kernel.fix16, &pc, per_op);
+
+      printf("%-9s", kernel.name);
+      for (int i = 0; i < PERF_COUNTERS_COUNT; i++)
+      {
+        if (perf_counter_available(&pc, i))
+        {
+          result_for(kernel.name).perf[i] = per_op[i];
+          printf(" %13.3f", per_op[i]);
+        }
+        else
+          printf(" %13s", "n/a");
+      }
+      printf("\n");
+    }
+    perf_counters_close(&pc);
+  }
+
+  if (g_latency)
+  {
+    uint32_t overhead = latency_overhead();
+    printf("\nLatency per fix16 call in " TICKS_UNIT " (timing overhead of %u subtracted)\n",
+           overhead);
+    printf("%-9s %9s %7s %7s %7s %7s %7s\n",
+           "Op", "calls", "min", "p50", "p99", "p99.9", "max");
+
+    for (unsigned k = 0; k < KERNELS_COUNT; k++)
+    {
+      const Kernel &kernel = kernels[k];
+      if ((g_filter && strcmp(g_filter, kernel.name)) || !kernel.latency)
+        continue;
+      report_latency(kernel, overhead);
+    }
+  }
+
+  if (g_json && !write_json(g_json))
+    return 1;
+
+  return 0;
+}
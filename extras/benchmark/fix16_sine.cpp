@@ -0,0 +1,276 @@
+/* Accuracy versus cost report for the sine implementations.
+ *
+ * fix16_trig.c is compiled several times into this tool, each time into its
+ * own namespace with a different set of FIXMATH_* options, so that all sine
+ * paths can be compared side by side in one binary:
+ *
+ *   taylor         Taylor series (default), without cache
+ *   taylor_cached  Taylor series with the 4096 entry cache
+ *   fast_sin       FIXMATH_FAST_SIN polynomial
+ *   parabola       fix16_sin_parabola with the x^4 correction
+ *   parabola_fast  fix16_sin_parabola without it (FIXMATH_FAST_SIN)
+ *   lut            FIXMATH_SIN_LUT table
+ *
+ * Every variant is evaluated for all inputs in [-pi, pi], the domain of
+ * fix16_sin_parabola, against a long double reference. Since consecutive
+ * inputs never repeat, the cached variant shows the cost of cache misses.
+ *
+ * The footprint is taken from the symbol table of this binary: pass the
+ * output of 'nm -S -C' with -s. AVR cycle counts can be added with -c, the
+ * 'sine-report-avr' Makefile target collects them from the simulator.
+ */
+#include <fix16.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FIXMATH_NO_CACHE
+namespace taylor {
+#include "fix16_trig.c"
+}
+
+#define FIXMATH_FAST_SIN
+namespace fast_sin {
+#include "fix16_trig.c"
+}
+#undef FIXMATH_FAST_SIN
+#undef FIXMATH_NO_CACHE
+
+namespace taylor_cached {
+#include "fix16_trig.c"
+}
+
+#define FIXMATH_SIN_LUT
+#define FIXMATH_NO_CACHE
+namespace lut {
+#include "fix16_trig.c"
+}
+#undef FIXMATH_SIN_LUT
+#undef FIXMATH_NO_CACHE
+
+struct Variant
+{
+  const char *name;
+  fix16_t (*fn)(fix16_t);
+  const char *symbols;     // nm symbol prefixes making up the footprint
+
+  // Results
+  double ns;
+  double max_err;
+  double rms_err;
+  long   ram;
+  long   flash;
+  long   avr_cycles;
+};
+
+static Variant variants[] = {
+  { "taylor",        taylor::fix16_sin,            "taylor::fix16_sin(" },
+  { "taylor_cached", taylor_cached::fix16_sin,     "taylor_cached::fix16_sin( taylor_cached::_fix16_sin_" },
+  { "fast_sin",      fast_sin::fix16_sin,          "fast_sin::fix16_sin(" },
+  { "parabola",      taylor::fix16_sin_parabola,   "taylor::fix16_sin_parabola(" },
+  { "parabola_fast", fast_sin::fix16_sin_parabola, "fast_sin::fix16_sin_parabola(" },
+  { "lut",           lut::fix16_sin,               "lut::fix16_sin( lut::_fix16_sin_" },
+};
+
+#define VARIANTS_COUNT (sizeof(variants)/sizeof(variants[0]))
+
+static volatile fix16_t sink;
+
+static uint64_t now_ns( void )
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void measure_error(Variant &v)
+{
+  double max_err = 0, sum_sq = 0;
+  long count = 0;
+  for (fix16_t x = -fix16_pi; x <= fix16_pi; x++)
+  {
+    long double expected = sinl(x / 65536.0L) * 65536.0L;
+    double err = fabsl(v.fn(x) - expected);
+    if (err > max_err) max_err = err;
+    sum_sq += err * err;
+    count++;
+  }
+  v.max_err = max_err;
+  v.rms_err = sqrt(sum_sq / count);
+}
+
+// Best time per call out of runs passes over [-pi, pi].
+static void measure_speed(Variant &v, int runs)
+{
+  double best = 0;
+  for (int r = 0; r < runs; r++)
+  {
+    uint64_t t0 = now_ns();
+    for (fix16_t x = -fix16_pi; x <= fix16_pi; x++)
+      sink = v.fn(x);
+    double ns = (double)(now_ns() - t0) / (2 * fix16_pi + 1);
+    if (r == 0 || ns < best)
+      best = ns;
+  }
+  v.ns = best;
+}
+
+static bool symbol_matches(const char *symbols, const char *name)
+{
+  char buf[256];
+  strncpy(buf, symbols, sizeof(buf) - 1);
+  buf[sizeof(buf) - 1] = '\0';
+  for (char *prefix = strtok(buf, " "); prefix; prefix = strtok(NULL, " "))
+  {
+    if (!strncmp(name, prefix, strlen(prefix)))
+      return true;
+  }
+  return false;
+}
+
+// Reads 'nm -S -C' output: address, size, type and name per line.
+static bool read_footprint(const char *path)
+{
+  FILE *f = fopen(path, "r");
+  if (!f)
+  {
+    perror(path);
+    return false;
+  }
+
+  for (unsigned i = 0; i < VARIANTS_COUNT; i++)
+    variants[i].ram = variants[i].flash = 0;
+
+  char line[512];
+  while (fgets(line, sizeof(line), f))
+  {
+    unsigned long long addr, size;
+    char type;
+    int name_at;
+    if (sscanf(line, "%llx %llx %c %n", &addr, &size, &type, &name_at) != 3)
+      continue;
+
+    const char *name = line + name_at;
+    for (unsigned i = 0; i < VARIANTS_COUNT; i++)
+    {
+      if (!symbol_matches(variants[i].symbols, name))
+        continue;
+      if (strchr("tTrR", type))
+        variants[i].flash += size;
+      else if (strchr("dDbB", type))
+        variants[i].ram += size;
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+// A variant is on the Pareto front if no other one is at least as good in
+// speed, RMS error and (when known) total footprint, and better in one.
+static bool dominates(const Variant &a, const Variant &b)
+{
+  long size_a = a.ram + a.flash, size_b = b.ram + b.flash;
+  bool sizes = (a.ram >= 0 && b.ram >= 0);
+  if (a.ns > b.ns || a.rms_err > b.rms_err || (sizes && size_a > size_b))
+    return false;
+  return a.ns < b.ns || a.rms_err < b.rms_err || (sizes && size_a < size_b);
+}
+
+static bool pareto_optimal(unsigned i)
+{
+  for (unsigned j = 0; j < VARIANTS_COUNT; j++)
+  {
+    if (j != i && dominates(variants[j], variants[i]))
+      return false;
+  }
+  return true;
+}
+
+static void usage(const char *argv0)
+{
+  fprintf(stderr,
+    "Usage: %s [-r runs] [-s nm_output] [-c variant=cycles]...\n"
+    "  -r runs            best-of-N timing passes (default 5)\n"
+    "  -s nm_output       'nm -S -C' output of this binary, for the footprint\n"
+    "  -c variant=cycles  AVR cycles per call of a variant\n",
+    argv0);
+}
+
+int main(int argc, char **argv)
+{
+  int runs = 5;
+  bool have_footprint = false;
+
+  for (unsigned i = 0; i < VARIANTS_COUNT; i++)
+    variants[i].ram = variants[i].flash = variants[i].avr_cycles = -1;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "-r") && i + 1 < argc)
+      runs = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+    {
+      if (!read_footprint(argv[++i]))
+        return 1;
+      have_footprint = true;
+    }
+    else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+    {
+      const char *arg = argv[++i];
+      const char *eq = strchr(arg, '=');
+      unsigned v;
+      for (v = 0; eq && v < VARIANTS_COUNT; v++)
+      {
+        if (strlen(variants[v].name) == (size_t)(eq - arg)
+            && !strncmp(variants[v].name, arg, eq - arg))
+        {
+          variants[v].avr_cycles = atol(eq + 1);
+          break;
+        }
+      }
+      if (!eq || v == VARIANTS_COUNT)
+      {
+        usage(argv[0]);
+        return 1;
+      }
+    }
+    else
+    {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (runs < 1) runs = 1;
+
+  for (unsigned i = 0; i < VARIANTS_COUNT; i++)
+  {
+    measure_error(variants[i]);
+    measure_speed(variants[i], runs);
+  }
+
+  printf("| %-13s | %8s | %10s | %11s | %11s | %9s | %9s | %6s |\n",
+         "Variant", "ns/op", "AVR cycles", "max err LSB", "RMS err LSB",
+         "RAM bytes", "flash", "pareto");
+  printf("|---------------|---------:|-----------:|------------:|------------:|----------:|----------:|--------|\n");
+
+  for (unsigned i = 0; i < VARIANTS_COUNT; i++)
+  {
+    const Variant &v = variants[i];
+    char cycles[24] = "n/a", ram[24] = "n/a", flash[24] = "n/a";
+    if (v.avr_cycles >= 0) snprintf(cycles, sizeof(cycles), "%ld", v.avr_cycles);
+    if (have_footprint)
+    {
+      snprintf(ram, sizeof(ram), "%ld", v.ram);
+      snprintf(flash, sizeof(flash), "%ld", v.flash);
+    }
+
+    printf("| %-13s | %8.2f | %10s | %11.1f | %11.2f | %9s | %9s | %6s |\n",
+           v.name, v.ns, cycles, v.max_err, v.rms_err, ram, flash,
+           pareto_optimal(i) ? "yes" : "");
+  }
+
+  return 0;
+}
@@ -0,0 +1,283 @@
+/* Exhaustive accuracy and speed sweep for the unary fix16 functions.
+ *
+ * Evaluates every fix16_t input (or every n-th with -n) of sqrt, exp, log,
+ * log2, sin, atan and asin on all cores and compares each result against a
+ * long double reference. Reports the maximum and mean error in LSBs, the
+ * worst inputs and the throughput of the library function alone.
+ *
+ * The exp, sin and atan caches are not thread safe, so the Makefile builds
+ * this tool with FIXMATH_NO_CACHE on top of the configuration under test.
+ */
+#include <fix16.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define CHUNK_SIZE   (1 << 16)  // Inputs per work item
+#define WORST_COUNT  (5)        // Number of worst inputs reported
+
+struct Function
+{
+  const char *name;
+  fix16_t (*fix)(fix16_t);
+  long double (*ref)(long double);
+  bool (*domain)(fix16_t);      // Inputs the result is defined for
+  long double max_err;          // Error limit in LSBs, negative if none
+};
+
+static bool domain_all(fix16_t)        { return true; }
+static bool domain_positive(fix16_t x) { return x > 0; }
+static bool domain_unit(fix16_t x)     { return x >= -fix16_one && x <= fix16_one; }
+
+// fix16_sqrt returns -sqrt(-x) for negative inputs.
+static long double ref_sqrt(long double x) { return x < 0 ? -sqrtl(-x) : sqrtl(x); }
+static long double ref_exp(long double x)  { return expl(x);  }
+static long double ref_log(long double x)  { return logl(x);  }
+static long double ref_log2(long double x) { return log2l(x); }
+static long double ref_sin(long double x)  { return sinl(x);  }
+static long double ref_atan(long double x) { return atanl(x); }
+static long double ref_asin(long double x) { return asinl(x); }
+
+static Function functions[] = {
+  { "sqrt", fix16_sqrt, ref_sqrt, domain_all,      -1 },
+  { "exp",  fix16_exp,  ref_exp,  domain_all,      -1 },
+  { "log",  fix16_log,  ref_log,  domain_positive, -1 },
+  { "log2", fix16_log2, ref_log2, domain_positive, -1 },
+  { "sin",  fix16_sin,  ref_sin,  domain_all,      -1 },
+  { "atan", fix16_atan, ref_atan, domain_all,      -1 },
+  { "asin", fix16_asin, ref_asin, domain_unit,     -1 },
+};
+
+#define FUNCTIONS_COUNT (sizeof(functions)/sizeof(functions[0]))
+
+struct Worst
+{
+  fix16_t     input;
+  fix16_t     result;
+  long double expected;   // In LSBs
+  long double err;
+};
+
+struct Stats
+{
+  uint64_t    count;
+  long double sum_err;
+  long double max_err;
+  uint64_t    fix_ns;     // Time spent in the library function
+  Worst       worst[WORST_COUNT];
+  unsigned    worst_count;
+
+  Stats() : count(0), sum_err(0), max_err(0), fix_ns(0), worst_count(0) {}
+
+  void add_worst(const Worst &w)
+  {
+    unsigned i = worst_count;
+    if (i == WORST_COUNT)
+    {
+      if (w.err <= worst[WORST_COUNT - 1].err) return;
+      i--;
+    }
+    else
+      worst_count++;
+
+    // Insertion sort, largest error first.
+    while (i > 0 && worst[i - 1].err < w.err)
+    {
+      worst[i] = worst[i - 1];
+      i--;
+    }
+    worst[i] = w;
+  }
+
+  void merge(const Stats &other)
+  {
+    count   += other.count;
+    sum_err += other.sum_err;
+    fix_ns  += other.fix_ns;
+    if (other.max_err > max_err)
+      max_err = other.max_err;
+    for (unsigned i = 0; i < other.worst_count; i++)
+      add_worst(other.worst[i]);
+  }
+};
+
+static uint64_t now_ns( void )
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// Reference result in LSBs, saturated the way the library saturates.
+static long double expected_lsb(const Function &f, fix16_t x)
+{
+  long double r = f.ref((long double)x / 65536.0L) * 65536.0L;
+  if (!(r <= fix16_maximum)) return fix16_maximum; // Also catches +inf and NaN
+  if (r < fix16_minimum) return fix16_minimum;
+  return r;
+}
+
+static void sweep_chunk(const Function &f, uint64_t first, uint64_t step,
+                        uint64_t end, Stats &stats)
+{
+  static thread_local fix16_t inputs[CHUNK_SIZE];
+  static thread_local fix16_t results[CHUNK_SIZE];
+  unsigned n = 0;
+
+  for (uint64_t i = first; i < end && n < CHUNK_SIZE; i += step)
+  {
+    fix16_t x = (fix16_t)(uint32_t)i;
+    if (f.domain(x))
+      inputs[n++] = x;
+  }
+
+  // Time the library calls on their own, the reference is much slower.
+  uint64_t t0 = now_ns();
+  for (unsigned i = 0; i < n; i++)
+    results[i] = f.fix(inputs[i]);
+  stats.fix_ns += now_ns() - t0;
+
+  for (unsigned i = 0; i < n; i++)
+  {
+    long double expected = expected_lsb(f, inputs[i]);
+    long double err = fabsl((long double)results[i] - expected);
+    stats.count++;
+    stats.sum_err += err;
+    if (err > stats.max_err)
+      stats.max_err = err;
+    if (stats.worst_count < WORST_COUNT || err > stats.worst[WORST_COUNT - 1].err)
+    {
+      Worst w = { inputs[i], results[i], expected, err };
+      stats.add_worst(w);
+    }
+  }
+}
+
+static Stats sweep(const Function &f, uint64_t step, unsigned threads)
+{
+  const uint64_t total = (uint64_t)1 << 32;
+  const uint64_t chunk_span = (uint64_t)CHUNK_SIZE * step;
+  std::atomic<uint64_t> next(0);
+  std::mutex lock;
+  Stats result;
+
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; t++)
+  {
+    workers.push_back(std::thread([&]() {
+      Stats local;
+      uint64_t first;
+      while ((first = next.fetch_add(chunk_span)) < total)
+      {
+        uint64_t end = first + chunk_span;
+        sweep_chunk(f, first, step, end < total ? end : total, local);
+      }
+      std::lock_guard<std::mutex> guard(lock);
+      result.merge(local);
+    }));
+  }
+  for (unsigned t = 0; t < threads; t++)
+    workers[t].join();
+
+  return result;
+}
+
+static void usage(const char *argv0)
+{
+  fprintf(stderr,
+    "Usage: %s [-j threads] [-n step] [-f function] [-e function=lsb]...\n"
+    "  -j threads       number of worker threads (default: all cores)\n"
+    "  -n step          only evaluate every step-th input (default 1, all)\n"
+    "  -f function      only sweep the named function\n"
+    "  -e function=lsb  fail if the maximum error exceeds lsb\n",
+    argv0);
+}
+
+int main(int argc, char **argv)
+{
+  unsigned threads = std::thread::hardware_concurrency();
+  uint64_t step = 1;
+  const char *filter = NULL;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "-j") && i + 1 < argc)
+      threads = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+      step = strtoull(argv[++i], NULL, 0);
+    else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+      filter = argv[++i];
+    else if (!strcmp(argv[i], "-e") && i + 1 < argc)
+    {
+      const char *arg = argv[++i];
+      const char *eq = strchr(arg, '=');
+      unsigned f;
+      for (f = 0; eq && f < FUNCTIONS_COUNT; f++)
+      {
+        if (strlen(functions[f].name) == (size_t)(eq - arg)
+            && !strncmp(functions[f].name, arg, eq - arg))
+        {
+          functions[f].max_err = strtold(eq + 1, NULL);
+          break;
+        }
+      }
+      if (!eq || f == FUNCTIONS_COUNT)
+      {
+        usage(argv[0]);
+        return 1;
+      }
+    }
+    else
+    {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (threads < 1) threads = 1;
+  if (step < 1) step = 1;
+
+  printf("Sweeping every %llu. input on %u threads\n", (unsigned long long)step, threads);
+  printf("%-5s %12s %12s %12s %12s %14s\n",
+         "Func", "inputs", "max err", "mean err", "Mcalls/s", "wall time [s]");
+
+  int status = 0;
+  for (unsigned f = 0; f < FUNCTIONS_COUNT; f++)
+  {
+    const Function &func = functions[f];
+    if (filter && strcmp(filter, func.name))
+      continue;
+
+    uint64_t t0 = now_ns();
+    Stats stats = sweep(func, step, threads);
+    double wall = (now_ns() - t0) / 1e9;
+
+    // Throughput over all threads, from the time spent in the library only.
+    double mcalls = stats.fix_ns ? 1e3 * stats.count * threads / stats.fix_ns : 0;
+
+    printf("%-5s %12llu %12.2Lf %12.4Lf %12.2f %14.1f\n", func.name,
+           (unsigned long long)stats.count, stats.max_err,
+           stats.count ? stats.sum_err / stats.count : 0.0L, mcalls, wall);
+    for (unsigned i = 0; i < stats.worst_count; i++)
+    {
+      const Worst &w = stats.worst[i];
+      printf("      worst: %s(0x%08x = %.6f) = 0x%08x, expected %.2Lf, error %.2Lf LSB\n",
+             func.name, (uint32_t)w.input, fix16_to_dbl(w.input),
+             (uint32_t)w.result, w.expected, w.err);
+    }
+
+    if (func.max_err >= 0 && stats.max_err > func.max_err)
+    {
+      printf("FAILED: %s maximum error %.2Lf exceeds the limit of %.2Lf LSB\n",
+             func.name, stats.max_err, func.max_err);
+      status = 1;
+    }
+  }
+
+  return status;
+}
@@ -0,0 +1,75 @@
+/* Check of Fix16Range and Fix8Range, see fixmath_range.hpp.
+ *
+ * Their arithmetic has to give the results of Fix16 and Fix8 in every
+ * configuration, and overflowed writes must not widen the recorded range.
+ * Exits with 1 on the first mismatch.
+ */
+#include <fixmath_range.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+
+static unsigned g_failures = 0;
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { printf(__VA_ARGS__); printf("\n"); g_failures++; } } while (0)
+
+static uint32_t g_state = 12345;
+static uint32_t next_random()
+{
+  g_state ^= g_state << 13;
+  g_state ^= g_state >> 17;
+  g_state ^= g_state << 5;
+  return g_state;
+}
+
+// Values of all magnitudes, down to a few LSBs.
+template<typename Storage> static Storage random_value()
+{
+  uint32_t r = next_random();
+  int32_t v = (int32_t)r >> (32 - 8 * sizeof(Storage));
+  return (Storage)(v >> ((r & 0x1F) % (8 * sizeof(Storage))));
+}
+
+template<typename Fixed, typename Range> static void check_ops(const char *name)
+{
+  typedef decltype(Fixed().value) storage_t;
+  for (unsigned i = 0; i < 100000; i++)
+  {
+    Fixed a = random_value<storage_t>(), b = random_value<storage_t>();
+    Range x(name, a);
+    Fixed expected[4] = { a + b, a - b, a * b, a / b };
+    Range actual[4] = { Range(name, x + b), Range(name, x - b), Range(name, x * b), Range(name, x / b) };
+    for (unsigned op = 0; op < 4; op++)
+    {
+      if (op == 3 && b.value == 0)
+        continue;
+      CHECK(actual[op].value == expected[op].value, "%s: op %u of %ld, %ld gives %ld instead of %ld",
+            name, op, (long)a.value, (long)b.value, (long)actual[op].value, (long)expected[op].value);
+    }
+  }
+}
+
+// Overflowed writes count, but keep the range of the other writes.
+// The sticky overflows saturate, which the range classes do not detect.
+template<typename Fixed, typename Range> static void check_overflow(const char *name, double big)
+{
+  Range x(name, big);
+  x *= big;
+  x = 1.5;
+  CHECK(x.range->writes == 3, "%s: %lu writes", name, (unsigned long)x.range->writes);
+  CHECK(x.range->overflows == 1, "%s: %lu overflows", name, (unsigned long)x.range->overflows);
+  CHECK(x.range->min == Fixed(1.5).value && x.range->max == Fixed(big).value,
+        "%s: range %ld..%ld", name, (long)x.range->min, (long)x.range->max);
+}
+
+int main()
+{
+  check_ops<Fix16, Fix16Range>("fix16");
+  check_ops<Fix8, Fix8Range>("fix8");
+#if !defined(FIXMATH_NO_OVERFLOW) && !defined(FIXMATH_STICKY_OVERFLOW)
+  check_overflow<Fix16, Fix16Range>("fix16_overflow", 200.0);
+  check_overflow<Fix8, Fix8Range>("fix8_overflow", 100.0);
+#endif
+  printf("fixmath_range_test: %u failures\n", g_failures);
+  return g_failures ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+"""Flash and RAM footprint of the library per configuration and function.
+
+Compiles the library sources with -ffunction-sections -fdata-sections for
+each FIXMATH_* configuration, for the host and (when avr-gcc is available)
+for AVR, and links them into a relocatable object with a map file. Each
+function and variable then sits in its own input section, whose size is
+read from the map and reported as .text (code and read-only data, as
+'size' counts it), .data or .bss. On AVR read-only data is counted as
+.data, since it occupies RAM there.
+
+A budget file can set limits; the script exits non-zero when one is
+exceeded. Each line of it reads
+
+    <target> <config> <symbol> <section> <max bytes>
+
+where target is host or avr, config a configuration name as printed in
+the report (e.g. default, NO_CACHE or NO_64BIT+OPTIMIZE_8BIT), symbol a
+function or variable name, and section text, data or bss. config and
+symbol may be '*', meaning any configuration and the total over all
+symbols respectively. '#' starts a comment.
+"""
+
+import argparse
+import itertools
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+LIBDIR = os.path.normpath(os.path.join(HERE, '..', '..'))
+
+SOURCES = ['fix16.c', 'fix16_cache.c', 'fix16_exp.c', 'fix16_sqrt.c', 'fix16_str.c',
+           'fix16_trig.c', 'fix8.c', 'fixmath_profile.c',
+           'fixmath_trace.c']
+
+OPTIONS = ['NO_64BIT', 'OPTIMIZE_8BIT', 'NO_CACHE', 'SIN_LUT', 'FAST_SIN',
+           'NO_ROUNDING', 'NO_OVERFLOW', 'INLINE',
+           'DIV64', 'STICKY_OVERFLOW']
+
+SECTIONS = ('text', 'data', 'bss')
+
+# Input section entries of the map file: the section name, then (on the same
+# or the next line) its address, size and the object it comes from.
+MAP_ENTRY = re.compile(
+    r'^ (\.[\w.$]+)\s*\n?\s+0x[0-9a-f]+\s+0x([0-9a-f]+)\s+(\S+)$',
+    re.MULTILINE)
+
+
+def config_name(options):
+    return '+'.join(options) if options else 'default'
+
+
+def configurations(all_combinations):
+    if not all_combinations:
+        return [[]] + [[option] for option in OPTIONS]
+    configs = []
+    for n in range(len(OPTIONS) + 1):
+        configs.extend(list(c) for c in itertools.combinations(OPTIONS, n))
+    return configs
+
+
+def classify(target, section):
+    """Maps an input section name to (report section, symbol)."""
+    # AVR has no read-only data in flash: the linker copies .rodata into
+    # RAM, unless it is declared PROGMEM.
+    rodata = 'data' if target == 'avr' else 'text'
+    for prefix, kind in (('.text', 'text'), ('.rodata', rodata),
+                         ('.progmem', 'text'), ('.data', 'data'),
+                         ('.bss', 'bss')):
+        if section == prefix or section.startswith(prefix + '.'):
+            return kind, section[len(prefix) + 1:]
+    return None, None
+
+
+def build(target, cc, cflags, options, builddir):
+    """Compiles and partially links one configuration, returns the map."""
+    outdir = os.path.join(builddir, target, config_name(options))
+    os.makedirs(outdir, exist_ok=True)
+    flags = cflags + ['-ffunction-sections', '-fdata-sections',
+                      '-I' + LIBDIR] + ['-DFIXMATH_' + o for o in options]
+
+    objects = []
+    for source in SOURCES:
+        obj = os.path.join(outdir, source.replace('.c', '.o'))
+        subprocess.check_call([cc] + flags + ['-c', os.path.join(LIBDIR, source),
+                                              '-o', obj])
+        objects.append(obj)
+
+    # A relocatable link keeps every input section and has no memory
+    # regions, so configurations which do not fit the target still report.
+    mapfile = os.path.join(outdir, 'fixmath.map')
+    subprocess.check_call([cc] + flags + ['-nostdlib', '-r',
+                                          '-Wl,-Map=' + mapfile] + objects +
+                          ['-o', os.path.join(outdir, 'fixmath.o')])
+    return mapfile
+
+
+def parse_map(target, mapfile):
+    """Returns {symbol: {section: bytes}} from a map file."""
+    with open(mapfile) as f:
+        text = f.read()
+
+    symbols = {}
+    for section, size, origin in MAP_ENTRY.findall(text):
+        size = int(size, 16)
+        kind, symbol = classify(target, section)
+        if not kind or not size:
+            continue
+        if not symbol or symbol.startswith('str1.'):
+            # Unnamed sections and merged string constants
+            symbol = '(%s)' % os.path.basename(origin)
+        entry = symbols.setdefault(symbol, dict.fromkeys(SECTIONS, 0))
+        entry[kind] += size
+    return symbols
+
+
+def totals(symbols):
+    total = dict.fromkeys(SECTIONS, 0)
+    for entry in symbols.values():
+        for kind in SECTIONS:
+            total[kind] += entry[kind]
+    return total
+
+
+def read_budget(path):
+    budget = []
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            fields = line.split('#', 1)[0].split()
+            if not fields:
+                continue
+            if len(fields) != 5 or fields[3] not in SECTIONS:
+                sys.exit('%s:%d: expected <target> <config> <symbol> '
+                         '<text|data|bss> <max bytes>' % (path, lineno))
+            budget.append((fields[0], fields[1], fields[2], fields[3],
+                           int(fields[4], 0), '%s:%d' % (path, lineno)))
+    return budget
+
+
+def check_budget(budget, target, config, symbols):
+    failures = []
+    for b_target, b_config, b_symbol, kind, limit, where in budget:
+        if b_target != target or b_config not in ('*', config):
+            continue
+        if b_symbol == '*':
+            used = totals(symbols)[kind]
+        else:
+            used = symbols.get(b_symbol, {}).get(kind, 0)
+        if used > limit:
+            failures.append('%s: %s %s %s .%s is %d bytes, budget %d' %
+                            (where, target, config, b_symbol, kind, used, limit))
+    return failures
+
+
+def report(target, config, symbols, verbose):
+    total = totals(symbols)
+    print('%-5s %-52s %8d %8d %8d' % (target, config, total['text'],
+                                      total['data'], total['bss']))
+    if verbose:
+        for symbol in sorted(symbols, key=lambda s: -sum(symbols[s].values())):
+            entry = symbols[symbol]
+            print('        %-50s %8d %8d %8d' % (symbol, entry['text'],
+                                                  entry['data'], entry['bss']))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--target', choices=('host', 'avr', 'all'), default='all')
+    parser.add_argument('--all-combinations', action='store_true',
+                        help='every combination of the FIXMATH_* options, '
+                             'instead of each option on its own')
+    parser.add_argument('--budget', help='budget file to check against')
+    parser.add_argument('--verbose', '-v', action='store_true',
+                        help='list every function and variable')
+    parser.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    parser.add_argument('--cflags', default='-Os')
+    parser.add_argument('--avr-cc', default='avr-gcc')
+    parser.add_argument('--avr-mcu', default='atmega328p')
+    parser.add_argument('--build', default=os.path.join(HERE, 'build', 'footprint'))
+    args = parser.parse_args()
+
+    targets = []
+    if args.target in ('host', 'all'):
+        targets.append(('host', args.cc, args.cflags.split()))
+    if args.target in ('avr', 'all'):
+        if shutil.which(args.avr_cc):
+            targets.append(('avr', args.avr_cc, args.cflags.split() +
+                            ['-mmcu=' + args.avr_mcu]))
+        elif args.target == 'avr':
+            sys.exit('%s not found' % args.avr_cc)
+        else:
+            print('Skipping AVR, %s not found' % args.avr_cc)
+
+    budget = read_budget(args.budget) if args.budget else []
+    failures = []
+
+    print('%-5s %-52s %8s %8s %8s' % ('Tgt', 'Configuration', '.text', '.data', '.bss'))
+    for target, cc, cflags in targets:
+        for options in configurations(args.all_combinations):
+            config = config_name(options)
+            symbols = parse_map(target, build(target, cc, cflags, options, args.build))
+            report(target, config, symbols, args.verbose)
+            failures += check_budget(budget, target, config, symbols)
+
+    for failure in failures:
+        print('OVER BUDGET: ' + failure)
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
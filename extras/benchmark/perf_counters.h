@@ -0,0 +1,161 @@
+#ifndef __fixpt_benchmark_perf_counters_h__
+#define __fixpt_benchmark_perf_counters_h__
+
+/* Hardware performance counters for the host benchmarks, using
+ * perf_event_open on Linux. The counters are opened as one group so they
+ * cover exactly the same instructions, and only count user space.
+ *
+ * Where the kernel or the machine does not provide a counter (containers,
+ * virtual machines, perf_event_paranoid > 2), it reads as unavailable
+ * instead of failing the benchmark.
+ */
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum perf_counter_id
+{
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_L1D_MISSES,
+  PERF_LLC_MISSES,
+  PERF_BRANCH_MISSES,
+  PERF_COUNTERS_COUNT
+};
+
+static const char *const perf_counter_names[PERF_COUNTERS_COUNT] = {
+  "cycles", "instructions", "L1D misses", "LLC misses", "branch misses"
+};
+
+struct perf_counters
+{
+  int      fd[PERF_COUNTERS_COUNT];    // -1 if unavailable
+  int      leader;                     // fd of the group leader, -1 if none
+  uint64_t value[PERF_COUNTERS_COUNT]; // Last reading, scaled for multiplexing
+};
+
+#ifdef __linux__
+static int perf_open(uint32_t type, uint64_t config, int group)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = (group == -1);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID
+                   | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+/* Opens the counters, returns the number which are available. */
+static int perf_counters_open(struct perf_counters *pc)
+{
+  int available = 0;
+  pc->leader = -1;
+  for (int i = 0; i < PERF_COUNTERS_COUNT; i++)
+  {
+    pc->fd[i] = -1;
+    pc->value[i] = 0;
+  }
+
+#ifdef __linux__
+  const uint64_t l1d_miss = PERF_COUNT_HW_CACHE_L1D
+                          | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                          | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  const struct { uint32_t type; uint64_t config; } events[PERF_COUNTERS_COUNT] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES       },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS     },
+    { PERF_TYPE_HW_CACHE, l1d_miss                       },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES     },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES    },
+  };
+
+  for (int i = 0; i < PERF_COUNTERS_COUNT; i++)
+  {
+    pc->fd[i] = perf_open(events[i].type, events[i].config, pc->leader);
+    if (pc->fd[i] < 0)
+      continue;
+    if (pc->leader == -1)
+      pc->leader = pc->fd[i];
+    available++;
+  }
+#endif
+  return available;
+}
+
+static void perf_counters_close(struct perf_counters *pc)
+{
+#ifdef __linux__
+  for (int i = 0; i < PERF_COUNTERS_COUNT; i++)
+  {
+    if (pc->fd[i] >= 0)
+      close(pc->fd[i]);
+    pc->fd[i] = -1;
+  }
+  pc->leader = -1;
+#else
+  (void)pc;
+#endif
+}
+
+static inline void perf_counters_start(struct perf_counters *pc)
+{
+#ifdef __linux__
+  if (pc->leader < 0) return;
+  ioctl(pc->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(pc->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+  (void)pc;
+#endif
+}
+
+/* Stops counting and stores the counts in pc->value. */
+static inline void perf_counters_stop(struct perf_counters *pc)
+{
+#ifdef __linux__
+  if (pc->leader < 0) return;
+  ioctl(pc->leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+  struct {
+    uint64_t nr, time_enabled, time_running;
+    struct { uint64_t value, id; } values[PERF_COUNTERS_COUNT];
+  } data;
+  if (read(pc->leader, &data, sizeof(data)) < (ssize_t)(3 * sizeof(uint64_t)))
+    return;
+
+  // Scale up if the group was not on the PMU the whole time.
+  double scale = data.time_running ? (double)data.time_enabled / data.time_running : 0;
+
+  for (int i = 0; i < PERF_COUNTERS_COUNT; i++)
+  {
+    uint64_t id;
+    pc->value[i] = 0;
+    if (pc->fd[i] < 0 || ioctl(pc->fd[i], PERF_EVENT_IOC_ID, &id) < 0)
+      continue;
+    for (uint64_t j = 0; j < data.nr && j < PERF_COUNTERS_COUNT; j++)
+    {
+      if (data.values[j].id == id)
+        pc->value[i] = (uint64_t)(data.values[j].value * scale);
+    }
+  }
+#else
+  (void)pc;
+#endif
+}
+
+static inline int perf_counter_available(const struct perf_counters *pc, int i)
+{
+  return pc->fd[i] >= 0;
+}
+
+#endif
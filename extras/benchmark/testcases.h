@@ -0,0 +1,82 @@
+#ifndef __fixpt_benchmark_testcases_h__
+#define __fixpt_benchmark_testcases_h__
+
+#include <stdint.h>
+
+/* Same input set as examples/Fix16_benchmark and examples/Fix16_unittest,
+ * so host, simulator and on-target numbers can be compared directly.
+ */
+static const int32_t testcases[] = {
+  // Small numbers
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+  -1, -2, -3, -4, -5, -6, -7, -8, -9, -10,
+
+  // Integer numbers
+  0x10000, -0x10000, 0x20000, -0x20000, 0x30000, -0x30000,
+  0x40000, -0x40000, 0x50000, -0x50000, 0x60000, -0x60000,
+
+  // Fractions (1/2, 1/4, 1/8)
+  0x8000, -0x8000, 0x4000, -0x4000, 0x2000, -0x2000,
+
+  // Problematic carry
+  0xFFFF, -0xFFFF, 0x1FFFF, -0x1FFFF, 0x3FFFF, -0x3FFFF,
+
+  // Smallest and largest values
+  0x7FFFFFFF, (int32_t)0x80000000,
+
+  // Large random numbers
+  831858892, 574794913, 2147272293, -469161054, -961611615,
+  1841960234, 1992698389, 520485404, 560523116, -2094993050,
+  -876897543, -67813629, 2146227091, 509861939, -1073573657,
+
+  // Small random numbers
+  -14985, 30520, -83587, 41129, 42137, 58537, -2259, 84142,
+  -28283, 90914, 19865, 33191, 81844, -66273, -63215, -44459,
+  -11326, 84295, 47515, -39324,
+
+  // Tiny random numbers
+  -171, -359, 491, 844, 158, -413, -422, -737, -575, -330,
+  -376, 435, -311, 116, 715, -1024, -487, 59, 724, 993
+};
+
+#define TESTCASES_COUNT (sizeof(testcases)/sizeof(testcases[0]))
+
+/* Same input set as examples/Fix8_benchmark, i.e. the fix16 testcases
+ * scaled down to 8.8 format.
+ */
+static const int16_t testcases8[] = {
+  // Small numbers
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+  -1, -2, -3, -4, -5, -6, -7, -8, -9, -10,
+
+  // Integer numbers
+  0x100, -0x100, 0x200, -0x200, 0x300, -0x300,
+  0x400, -0x400, 0x500, -0x500, 0x600, -0x600,
+
+  // Fractions (1/2, 1/4, 1/8)
+  0x80, -0x80, 0x40, -0x40, 0x20, -0x20,
+
+  // Problematic carry
+  0xFF, -0xFF, 0x1FF, -0x1FF, 0x3FF, -0x3FF,
+
+  // Smallest and largest values
+  0x7FFF, (int16_t)0x8000,
+
+  // Large random numbers
+  831858892/0x10000,  574794913/0x10000, 2147272293/0x10000, -469161054/0x10000, -961611615/0x10000,
+  1841960234/0x10000, 1992698389/0x10000, 520485404/0x10000, 560523116/0x10000, -2094993050/0x10000,
+  -876897543/0x10000, -67813629/0x10000, 2146227091/0x10000, 509861939/0x10000, -1073573657/0x10000,
+
+  // Small random numbers
+  -14985/0x100, 30520/0x100, -83587/0x100, 41129/0x100, 42137/0x100, 58537/0x100, -2259/0x100, 84142/0x100,
+  -28283/0x100, 90914/0x100, 19865/0x100, 33191/0x100, 81844/0x100, -66273/0x100, -63215/0x100, -44459/0x100,
+  -11326/0x100, 84295/0x100, 47515/0x100, -39324/0x100,
+
+  // Tiny random numbers
+  -171/0x10, -359/0x10, 491/0x10, 844/0x10, 158/0x10, -413/0x10, -422/0x10, -737/0x10, -575/0x10, -330/0x10,
+  -376/0x10, 435/0x10, -311/0x10, 116/0x10, 715/0x10, -1024/0x10, -487/0x10, 59/0x10, 724/0x10, 993/0x10
+};
+
+#define TESTCASES8_COUNT (sizeof(testcases8)/sizeof(testcases8[0]))
+
+#endif
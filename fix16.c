@@ -1,178 +1,69 @@
+#include "fixmath_wrap.h"
 #include "fix16.h"
 #if !defined(FIXMATH_NO_64BIT)
 #include "int64.h"
 #endif
 
-/* Subtraction and addition with overflow detection.
- * The versions without overflow detection are inlined in the header.
+/* fix16_add, fix16_sub and fix16_mul, except the 8-bit version below, are
+ * in fix16_arith.h, which fix16.h has already included with FIXMATH_INLINE.
  */
-#ifndef FIXMATH_NO_OVERFLOW
-fix16_t fix16_add(fix16_t a, fix16_t b)
-{
-	// Use unsigned integers because overflow with signed integers is
-	// an undefined operation (http://www.airs.com/blog/archives/120).
-	uint32_t _a = a, _b = b;
-	uint32_t sum = _a + _b;
-
-	// Overflow can only happen if sign of a == sign of b, and then
-	// it causes sign of sum != sign of a.
-	if (!((_a ^ _b) & 0x80000000) && ((_a ^ sum) & 0x80000000))
-		return fix16_overflow;
-	
-	return sum;
-}
-
-fix16_t fix16_sub(fix16_t a, fix16_t b)
-{
-	uint32_t _a = a, _b = b;
-	uint32_t diff = _a - _b;
-
-	// Overflow can only happen if sign of a != sign of b, and then
-	// it causes sign of diff != sign of a.
-	if (((_a ^ _b) & 0x80000000) && ((_a ^ diff) & 0x80000000))
-		return fix16_overflow;
-	
-	return diff;
-}
-
-/* Saturating arithmetic */
-fix16_t fix16_sadd(fix16_t a, fix16_t b)
-{
-	fix16_t result = fix16_add(a, b);
-
-	if (result == fix16_overflow)
-		return (a >= 0) ? fix16_maximum : fix16_minimum;
-
-	return result;
-}	
-
-fix16_t fix16_ssub(fix16_t a, fix16_t b)
-{
-	fix16_t result = fix16_sub(a, b);
-
-	if (result == fix16_overflow)
-		return (a >= 0) ? fix16_maximum : fix16_minimum;
-
-	return result;
-}
+#ifndef FIX16_ARITH
+#define FIX16_ARITH
+#include "fix16_arith.h"
 #endif
 
+/* Variants (FIXMATH_VARIANT) share the flag of the default build. */
+#if defined(FIXMATH_STICKY_OVERFLOW) && !defined(FIXMATH_VARIANT)
+FIXMATH_THREAD_LOCAL uint8_t _fixmath_overflow_flag = 0;
+#endif
 
+/* The 8-bit fix16_mul and fix16_div below are implemented as the checked
+ * functions. With FIXMATH_NO_OVERFLOW, where those are not available, they
+ * are compiled as static functions without the overflow checks, which
+ * fix16_mul and fix16_div inline.
+ */
+#ifdef FIXMATH_NO_OVERFLOW
+#define FIX16_CHECKED static inline
+#else
+#define FIX16_CHECKED
+#endif
 
-/* 64-bit implementation for fix16_mul. Fastest version for e.g. ARM Cortex M3.
- * Performs a 32*32 -> 64bit multiplication. The middle 32 bits are the result,
- * bottom 16 bits are used for rounding, and upper 16 bits are used for overflow
- * detection.
+#ifndef FIXMATH_NO_OVERFLOW
+/* Saturating arithmetic. The checked functions saturate with a conditional
+ * move instead of a branch. With FIXMATH_STICKY_OVERFLOW fix16_add and
+ * fix16_sub saturate as well, and set the flag.
  */
- 
-#if !defined(FIXMATH_NO_64BIT) && !defined(FIXMATH_OPTIMIZE_8BIT)
-fix16_t fix16_mul(fix16_t inArg0, fix16_t inArg1)
+fix16_t fix16_sadd(fix16_t a, fix16_t b)
 {
-	int64_t product = (int64_t)inArg0 * inArg1;
-	
-	#ifndef FIXMATH_NO_OVERFLOW
-	// The upper 17 bits should all be the same (the sign).
-	uint32_t upper = (product >> 47);
-	#endif
-	
-	if (product < 0)
-	{
-		#ifndef FIXMATH_NO_OVERFLOW
-		if (~upper)
-				return fix16_overflow;
-		#endif
-		
-		#ifndef FIXMATH_NO_ROUNDING
-		// This adjustment is required in order to round -1/2 correctly
-		product--;
-		#endif
-	}
-	else
-	{
-		#ifndef FIXMATH_NO_OVERFLOW
-		if (upper)
-				return fix16_overflow;
-		#endif
-	}
-	
-	#ifdef FIXMATH_NO_ROUNDING
-	return product >> 16;
+	#ifdef FIXMATH_STICKY_OVERFLOW
+	return fix16_add(a, b);
 	#else
-	fix16_t result = product >> 16;
-	result += (product & 0x8000) >> 15;
-	
+	fix16_t result;
+	fix16_add_checked(a, b, &result);
 	return result;
 	#endif
 }
-#endif
 
-/* 32-bit implementation of fix16_mul. Potentially fast on 16-bit processors,
- * and this is a relatively good compromise for compilers that do not support
- * uint64_t. Uses 16*16->32bit multiplications.
- */
-#if defined(FIXMATH_NO_64BIT) && !defined(FIXMATH_OPTIMIZE_8BIT)
-fix16_t fix16_mul(fix16_t inArg0, fix16_t inArg1)
+fix16_t fix16_ssub(fix16_t a, fix16_t b)
 {
-	// Each argument is divided to 16-bit parts.
-	//					AB
-	//			*	 CD
-	// -----------
-	//					BD	16 * 16 -> 32 bit products
-	//				 CB
-	//				 AD
-	//				AC
-	//			 |----| 64 bit product
-	int32_t A = (inArg0 >> 16), C = (inArg1 >> 16);
-	uint32_t B = (inArg0 & 0xFFFF), D = (inArg1 & 0xFFFF);
-	
-	int32_t AC = A*C;
-	int32_t AD_CB = A*D + C*B;
-	uint32_t BD = B*D;
-	
-	int32_t product_hi = AC + (AD_CB >> 16);
-	
-	// Handle carry from lower 32 bits to upper part of result.
-	uint32_t ad_cb_temp = AD_CB << 16;
-	uint32_t product_lo = BD + ad_cb_temp;
-	if (product_lo < BD)
-		product_hi++;
-	
-#ifndef FIXMATH_NO_OVERFLOW
-	// The upper 17 bits should all be the same (the sign).
-	if (product_hi >> 31 != product_hi >> 15)
-		return fix16_overflow;
-#endif
-	
-#ifdef FIXMATH_NO_ROUNDING
-	return (product_hi << 16) | (product_lo >> 16);
-#else
-	// Subtracting 0x8000 (= 0.5) and then using signed right shift
-	// achieves proper rounding to result-1, except in the corner
-	// case of negative numbers and lowest word = 0x8000.
-	// To handle that, we also have to subtract 1 for negative numbers.
-	uint32_t product_lo_tmp = product_lo;
-	product_lo -= 0x8000;
-	product_lo -= (uint32_t)product_hi >> 31;
-	if (product_lo > product_lo_tmp)
-		product_hi--;
-	
-	// Discard the lowest 16 bits. Note that this is not exactly the same
-	// as dividing by 0x10000. For example if product = -1, result will
-	// also be -1 and not 0. This is compensated by adding +1 to the result
-	// and compensating this in turn in the rounding above.
-	fix16_t result = (product_hi << 16) | (product_lo >> 16);
-	result += 1;
+	#ifdef FIXMATH_STICKY_OVERFLOW
+	return fix16_sub(a, b);
+	#else
+	fix16_t result;
+	fix16_sub_checked(a, b, &result);
 	return result;
-#endif
+	#endif
 }
 #endif
 
-/* 8-bit implementation of fix16_mul. Fastest on e.g. Atmel AVR.
+
+
+/* 8-bit implementation of fix16_mul_checked. Fastest on e.g. Atmel AVR.
  * Uses 8*8->16bit multiplications, and also skips any bytes that
  * are zero.
  */
 #if defined(FIXMATH_OPTIMIZE_8BIT)
-fix16_t fix16_mul(fix16_t inArg0, fix16_t inArg1)
+FIX16_CHECKED int fix16_mul_checked(fix16_t inArg0, fix16_t inArg1, fix16_t *result)
 {
 	uint32_t _a = (inArg0 >= 0) ? inArg0 : (-inArg0);
 	uint32_t _b = (inArg1 >= 0) ? inArg1 : (-inArg1);
@@ -187,7 +78,7 @@ fix16_t fix16_mul(fix16_t inArg0, fix16_t inArg1)
 
 	#ifndef FIXMATH_NO_OVERFLOW
 	// i = 6
-	if (va[3] && vb[3]) return fix16_overflow;
+	if (va[3] && vb[3]) return _fix16_overflowed(result, (inArg0 ^ inArg1) < 0);
 	#endif
 	
 	// i = 5
@@ -201,7 +92,7 @@ fix16_t fix16_mul(fix16_t inArg0, fix16_t inArg1)
 	if (va[3] && vb[1]) mid += (uint16_t)va[3] * vb[1];
 	
 	#ifndef FIXMATH_NO_OVERFLOW
-	if (mid & 0xFF000000) return fix16_overflow;
+	if (mid & 0xFF000000) return _fix16_overflowed(result, (inArg0 ^ inArg1) < 0);
 	#endif
 	mid <<= 8;
 	
@@ -212,7 +103,7 @@ fix16_t fix16_mul(fix16_t inArg0, fix16_t inArg1)
 	if (va[3] && vb[0]) mid += (uint16_t)va[3] * vb[0];
 	
 	#ifndef FIXMATH_NO_OVERFLOW
-	if (mid & 0xFF000000) return fix16_overflow;
+	if (mid & 0xFF000000) return _fix16_overflowed(result, (inArg0 ^ inArg1) < 0);
 	#endif
 	mid <<= 8;
 	
@@ -236,44 +127,86 @@ fix16_t fix16_mul(fix16_t inArg0, fix16_t inArg1)
 	
 	#ifndef FIXMATH_NO_OVERFLOW
 	if (mid & 0x80000000)
-		return fix16_overflow;
+		return _fix16_overflowed(result, (inArg0 ^ inArg1) < 0);
 	#endif
 	
-	fix16_t result = mid;
-	
 	/* Figure out the sign of result */
 	if ((inArg0 >= 0) != (inArg1 >= 0))
 	{
-		result = -result;
+		mid = -mid;
 	}
 	
+	*result = mid;
+	return 0;
+}
+
+fix16_t fix16_mul(fix16_t inArg0, fix16_t inArg1)
+{
+	fix16_t result;
+	if (fix16_mul_checked(inArg0, inArg1, &result))
+		return _FIX16_OVERFLOW(result < 0);
+	
 	return result;
 }
 #endif
 
 #ifndef FIXMATH_NO_OVERFLOW
-/* Wrapper around fix16_mul to add saturating arithmetic. */
+/* Saturating multiplication, see fix16_sadd. */
 fix16_t fix16_smul(fix16_t inArg0, fix16_t inArg1)
 {
-	fix16_t result = fix16_mul(inArg0, inArg1);
+	#ifdef FIXMATH_STICKY_OVERFLOW
+	return fix16_mul(inArg0, inArg1);
+	#else
+	fix16_t result;
+	fix16_mul_checked(inArg0, inArg1, &result);
+	return result;
+	#endif
+}
+#endif
+
+/* 64-bit implementation of fix16_div_checked, selected by FIXMATH_DIV64 on 64-bit
+ * processors. Computes (a << 17) / b with one hardware division and rounds
+ * and detects overflow the same way as the 32-bit version below.
+ */
+#if defined(FIXMATH_DIV64)
+FIX16_CHECKED int fix16_div_checked(fix16_t a, fix16_t b, fix16_t *result)
+{
+	if (b == 0)
+			return _fix16_overflowed(result, a < 0);
 	
-	if (result == fix16_overflow)
-	{
-		if ((inArg0 >= 0) == (inArg1 >= 0))
-			return fix16_maximum;
-		else
-			return fix16_minimum;
-	}
+	uint32_t remainder = (a >= 0) ? a : (-(uint32_t)a);
+	uint32_t divider = (b >= 0) ? b : (-(uint32_t)b);
+	uint64_t quotient64 = ((uint64_t)remainder << 17) / divider;
 	
-	return result;
+	#ifndef FIXMATH_NO_OVERFLOW
+	if (quotient64 >> 32)
+			return _fix16_overflowed(result, (a ^ b) < 0);
+	#endif
+	
+	uint32_t quotient = quotient64;
+	
+	#ifndef FIXMATH_NO_ROUNDING
+	// Quotient is always positive so rounding is easy
+	quotient++;
+	#endif
+	
+	quotient >>= 1;
+	
+	// Figure out the sign of the result. A negated 0x80000000 is
+	// fix16_minimum, which is not an overflow.
+	if ((a ^ b) & 0x80000000)
+		quotient = -quotient;
+	
+	*result = quotient;
+	return 0;
 }
 #endif
 
-/* 32-bit implementation of fix16_div. Fastest version for e.g. ARM Cortex M3.
+/* 32-bit implementation of fix16_div_checked. Fastest version for e.g. ARM Cortex M3.
  * Performs 32-bit divisions repeatedly to reduce the remainder. For this to
  * be efficient, the processor has to have 32-bit hardware division.
  */
-#if !defined(FIXMATH_OPTIMIZE_8BIT)
+#if !defined(FIXMATH_OPTIMIZE_8BIT) && !defined(FIXMATH_DIV64)
 #ifdef __GNUC__
 // Count leading zeros, using processor-specific instruction if available.
 #define clz(x) (__builtin_clzl(x) - (8 * sizeof(long) - 32))
@@ -288,13 +221,13 @@ static uint8_t clz(uint32_t x)
 }
 #endif
 
-fix16_t fix16_div(fix16_t a, fix16_t b)
+FIX16_CHECKED int fix16_div_checked(fix16_t a, fix16_t b, fix16_t *result)
 {
 	// This uses a hardware 32/32 bit division multiple times, until we have
 	// computed all the bits in (a<<17)/b. Usually this takes 1-3 iterations.
 	
 	if (b == 0)
-			return fix16_minimum;
+			return _fix16_overflowed(result, a < 0);
 	
 	uint32_t remainder = (a >= 0) ? a : (-a);
 	uint32_t divider = (b >= 0) ? b : (-b);
@@ -332,7 +265,7 @@ fix16_t fix16_div(fix16_t a, fix16_t b)
 
 		#ifndef FIXMATH_NO_OVERFLOW
 		if (div & ~(0xFFFFFFFF >> bit_pos))
-				return fix16_overflow;
+				return _fix16_overflowed(result, (a ^ b) < 0);
 		#endif
 		
 		remainder <<= 1;
@@ -344,29 +277,24 @@ fix16_t fix16_div(fix16_t a, fix16_t b)
 	quotient++;
 	#endif
 	
-	fix16_t result = quotient >> 1;
+	quotient >>= 1;
 	
-	// Figure out the sign of the result
+	// Figure out the sign of the result. A negated 0x80000000 is
+	// fix16_minimum, which is not an overflow.
 	if ((a ^ b) & 0x80000000)
-	{
-		#ifndef FIXMATH_NO_OVERFLOW
-		if (result == fix16_minimum)
-				return fix16_overflow;
-		#endif
-		
-		result = -result;
-	}
+		quotient = -quotient;
 	
-	return result;
+	*result = quotient;
+	return 0;
 }
 #endif
 
-/* Alternative 32-bit implementation of fix16_div. Fastest on e.g. Atmel AVR.
+/* Alternative 32-bit implementation of fix16_div_checked. Fastest on e.g. Atmel AVR.
  * This does the division manually, and is therefore good for processors that
  * do not have hardware division.
  */
 #if defined(FIXMATH_OPTIMIZE_8BIT)
-fix16_t fix16_div(fix16_t a, fix16_t b)
+FIX16_CHECKED int fix16_div_checked(fix16_t a, fix16_t b, fix16_t *result)
 {
 	// This uses the basic binary restoring division algorithm.
 	// It appears to be faster to do the whole division manually than
@@ -374,7 +302,7 @@ fix16_t fix16_div(fix16_t a, fix16_t b)
 	// platforms without hardware divide.
 	
 	if (b == 0)
-		return fix16_minimum;
+		return _fix16_overflowed(result, a < 0);
 	
 	uint32_t remainder = (a >= 0) ? a : (-a);
 	uint32_t divider = (b >= 0) ? b : (-b);
@@ -391,7 +319,7 @@ fix16_t fix16_div(fix16_t a, fix16_t b)
 	
 	#ifndef FIXMATH_NO_OVERFLOW
 	if (!bit)
-		return fix16_overflow;
+		return _fix16_overflowed(result, (a ^ b) < 0);
 	#endif
 	
 	if (divider & 0x80000000)
@@ -427,41 +355,217 @@ fix16_t fix16_div(fix16_t a, fix16_t b)
 	}
 	#endif
 	
-	fix16_t result = quotient;
+	#ifndef FIXMATH_NO_OVERFLOW
+	// Only a negative result, fix16_minimum, can have the highest bit set.
+	if (quotient > (uint32_t)fix16_maximum + ((a ^ b) < 0))
+		return _fix16_overflowed(result, (a ^ b) < 0);
+	#endif
 	
-	/* Figure out the sign of result */
+	/* Figure out the sign of result. A negated 0x80000000 is
+	 * fix16_minimum, which is not an overflow.
+	 */
 	if ((a ^ b) & 0x80000000)
-	{
-		#ifndef FIXMATH_NO_OVERFLOW
-		if (result == fix16_minimum)
-				return fix16_overflow;
-		#endif
-		
-		result = -result;
-	}
+		quotient = -quotient;
 	
-	return result;
+	*result = quotient;
+	return 0;
 }
 #endif
 
+fix16_t fix16_div(fix16_t a, fix16_t b)
+{
+	fix16_t result;
+	if (fix16_div_checked(a, b, &result))
+		return _FIX16_OVERFLOW(result < 0);
+	
+	return result;
+}
+
 #ifndef FIXMATH_NO_OVERFLOW
-/* Wrapper around fix16_div to add saturating arithmetic. */
+/* Saturating division, see fix16_sadd. */
 fix16_t fix16_sdiv(fix16_t inArg0, fix16_t inArg1)
 {
-	fix16_t result = fix16_div(inArg0, inArg1);
+	#ifdef FIXMATH_STICKY_OVERFLOW
+	return fix16_div(inArg0, inArg1);
+	#else
+	fix16_t result;
+	fix16_div_checked(inArg0, inArg1, &result);
+	return result;
+	#endif
+}
+#endif
+
+/* fix16_recip computes 2^33 / |x|, rounds it like fix16_div and returns the
+ * same result as fix16_div(fix16_one, x) with FIXMATH_DIV64, i.e. within 0.5
+ * LSB of 1/x. Inputs of magnitude 0 to 2 are passed on to fix16_div, which
+ * handles the division by zero and the overflows.
+ */
+
+#if !defined(FIXMATH_OPTIMIZE_8BIT)
+/* 32-bit implementation of fix16_recip, also used with FIXMATH_DIV64. Where
+ * fix16_div needs a 64/32 bit division or up to 3 32/32 bit divisions, a
+ * single 32/32 bit hardware division is enough here:
+ * 2^33 = 2 * (0xFFFFFFFF / d) * d + 2 * (0xFFFFFFFF % d + 1).
+ */
+fix16_t fix16_recip(fix16_t x)
+{
+	uint32_t divider = (x >= 0) ? x : (-(uint32_t)x);
+	
+	if (divider <= 2)
+		return fix16_div(fix16_one, x);
+	
+	uint32_t quotient = 0xFFFFFFFF / divider;
+	uint32_t remainder = 0xFFFFFFFF - quotient * divider + 1;
+	quotient = 2 * quotient + (remainder >= divider - remainder) + (remainder == divider);
+	
+	#ifndef FIXMATH_NO_ROUNDING
+	quotient++;
+	#endif
+	
+	fix16_t result = quotient >> 1;
+	return (x < 0) ? -result : result;
+}
+#endif
+
+#if defined(FIXMATH_OPTIMIZE_8BIT)
+/* 8-bit implementation of fix16_recip, for processors without hardware
+ * division. A 16 entry table gives 1/x to 5 bits, three Newton steps
+ * y = y * (2 - n * y) then 10, 20 and 30 bits, and the last bit comes from
+ * correcting the quotient against 2^33. The first step is done on 16 bits
+ * and the second, y still having only 16 bits, with 32*16 bit products.
+ */
+
+// Reciprocals (1 + seed / 256) of the middle of [16 + i, 17 + i) / 32.
+static const uint8_t _fix16_recip_seed[16] = {
+	240, 212, 187, 164, 144, 125, 108, 93, 78, 65, 53, 42, 31, 22, 13, 4
+};
+
+// (a * b) >> 16
+static uint32_t mul_hi16(uint32_t a, uint16_t b)
+{
+	return (a >> 16) * b + (((a & 0xFFFF) * b) >> 16);
+}
+
+fix16_t fix16_recip(fix16_t x)
+{
+	uint32_t divider = (x >= 0) ? x : (-(uint32_t)x);
+	uint32_t lo;
+	
+	if (divider <= 2)
+		return fix16_div(fix16_one, x);
+	
+	// n = divider normalized to [2^31, 2^32), y ~ 2^62 / n in [2^30, 2^31].
+	uint_fast8_t shift = 0;
+	uint32_t n = divider;
+	while (!(n & 0xFFFF0000)) { n <<= 16; shift += 16; }
+	while (!(n & 0xFF000000)) { n <<= 8; shift += 8; }
+	while (!(n & 0x80000000)) { n <<= 1; shift++; }
+	
+	uint16_t y16 = 0x4000 + ((uint16_t)_fix16_recip_seed[(n >> 27) & 0xF] << 6);
+	int16_t error16 = 0x4000 - (uint16_t)(((uint32_t)(uint16_t)(n >> 16) * y16) >> 16);
+	y16 += (int16_t)(((int32_t)y16 * error16) >> 14);
+	
+	uint32_t y = (uint32_t)y16 << 16;
+	int32_t error = 0x40000000 - mul_hi16(n, y16);
+	if (error >= 0)
+		y += mul_hi16((uint32_t)error << 2, y16);
+	else
+		y -= mul_hi16((uint32_t)(-error) << 2, y16);
+	
+	error = 0x40000000 - _fix16_mul_hi(n, y, &lo);
+	if (error >= 0)
+		y += _fix16_mul_hi(y, (uint32_t)error << 2, &lo);
+	else
+		y -= _fix16_mul_hi(y, (uint32_t)(-error) << 2, &lo);
 	
-	if (result == fix16_overflow)
+	// Correct the quotient so that quotient * divider <= 2^33 < (quotient + 1) * divider.
+	uint32_t quotient = (shift <= 29) ? (y >> (29 - shift)) : (y << (shift - 29));
+	uint32_t hi = _fix16_mul_hi(quotient, divider, &lo);
+	while (hi > 2 || (hi == 2 && lo))
 	{
-		if ((inArg0 >= 0) == (inArg1 >= 0))
-			return fix16_maximum;
-		else
-			return fix16_minimum;
+		quotient--;
+		if (lo < divider) hi--;
+		lo -= divider;
+	}
+	while (hi < 1 || (hi == 1 && lo <= 0 - divider))
+	{
+		quotient++;
+		lo += divider;
+		if (lo < divider) hi++;
 	}
 	
-	return result;
+	#ifndef FIXMATH_NO_ROUNDING
+	quotient++;
+	#endif
+	
+	fix16_t result = quotient >> 1;
+	return (x < 0) ? -result : result;
 }
 #endif
 
+/* The reciprocal of fix16_divider_t is rounded up and has enough bits, 17 + 32
+ * + shift, that its error stays below 1/|divisor| for any 32-bit |a|. So
+ * fix16_div_by gets the exact (|a| << 17) / |divisor| that fix16_div rounds.
+ */
+fix16_divider_t fix16_divider(fix16_t divisor)
+{
+	fix16_divider_t result = { 0, 0, 0, divisor };
+	uint32_t divider = (divisor >= 0) ? divisor : (-(uint32_t)divisor);
+	
+	if (divider == 0)
+		return result;
+	
+	#if !defined(FIXMATH_OPTIMIZE_8BIT) && !defined(FIXMATH_DIV64)
+	// The 32-bit fix16_div can be 1 LSB off from the exact quotient for
+	// divisors from 16.0, so keep using it for those.
+	if (divider & 0xFFF00000)
+		return result;
+	#endif
+	
+	// |divisor| is at most 2^31.
+	while (result.shift < 31 && ((uint32_t)1 << result.shift) < divider)
+		result.shift++;
+	
+	#ifndef FIXMATH_NO_64BIT
+	// 2^(49 + shift) / divider in two steps, the quotient has 50 bits.
+	uint64_t numerator = (uint64_t)1 << (17 + result.shift);
+	uint64_t rest = (numerator % divider) << 32;
+	result.magic_hi = numerator / divider;
+	result.magic_lo = rest / divider;
+	rest %= divider;
+	#else
+	// The same by long division, one bit of the numerator at a time.
+	uint32_t rest = 0;
+	uint8_t i;
+	for (i = 0; i < 50 + result.shift; i++)
+	{
+		rest = (rest << 1) | (i == 0);
+		result.magic_hi = (result.magic_hi << 1) | (result.magic_lo >> 31);
+		result.magic_lo <<= 1;
+		if (rest >= divider)
+		{
+			rest -= divider;
+			result.magic_lo |= 1;
+		}
+	}
+	#endif
+	
+	if (rest)
+	{
+		if (++result.magic_lo == 0)
+			result.magic_hi++;
+	}
+	
+	return result;
+}
+
+void fix16_div_by_array(fix16_t *out, const fix16_t *in, uint32_t count, const fix16_divider_t *divider)
+{
+	uint32_t i;
+	for (i = 0; i < count; i++)
+		out[i] = fix16_div_by(in[i], divider);
+}
+
 fix16_t fix16_mod(fix16_t x, fix16_t y)
 {
 	#ifdef FIXMATH_OPTIMIZE_8BIT
@@ -509,3 +613,51 @@ fix16_t fix16_lerp32(fix16_t inArg0, fix16_t inArg1, uint32_t inFract)
 	return (fix16_t)tempOut;
 }
 #endif
+
+#ifdef FIXMATH_WRAP
+#undef fix16_add
+#undef fix16_sub
+#undef fix16_sadd
+#undef fix16_ssub
+#undef fix16_mul
+#undef fix16_div
+#undef fix16_smul
+#undef fix16_sdiv
+#undef fix16_mul_checked
+#undef fix16_div_checked
+#undef fix16_recip
+#undef fix16_divider
+#undef fix16_div_by_array
+#undef fix16_mod
+#undef fix16_lerp8
+#undef fix16_lerp16
+#undef fix16_lerp32
+#ifndef FIXMATH_NO_OVERFLOW
+FIXMATH_WRAP2_OVERFLOW(fix16_t, fix16_add, FIXMATH_OP_FIX16_ADD, fix16_overflow)
+FIXMATH_WRAP2_OVERFLOW(fix16_t, fix16_sub, FIXMATH_OP_FIX16_SUB, fix16_overflow)
+FIXMATH_WRAP2(fix16_t, fix16_sadd, fix16_t, fix16_t)
+FIXMATH_WRAP2(fix16_t, fix16_ssub, fix16_t, fix16_t)
+FIXMATH_WRAP2(fix16_t, fix16_smul, fix16_t, fix16_t)
+FIXMATH_WRAP2(fix16_t, fix16_sdiv, fix16_t, fix16_t)
+#ifdef FIXMATH_OPTIMIZE_8BIT
+FIXMATH_WRAP3(int, fix16_mul_checked, fix16_t, fix16_t, fix16_t *)
+#endif
+FIXMATH_WRAP3(int, fix16_div_checked, fix16_t, fix16_t, fix16_t *)
+#endif
+#ifndef FIXMATH_NO_OVERFLOW
+FIXMATH_WRAP2_OVERFLOW(fix16_t, fix16_mul, FIXMATH_OP_FIX16_MUL, fix16_overflow)
+FIXMATH_WRAP2_OVERFLOW(fix16_t, fix16_div, FIXMATH_OP_FIX16_DIV, fix16_overflow)
+#else
+FIXMATH_WRAP2(fix16_t, fix16_mul, fix16_t, fix16_t)
+FIXMATH_WRAP2(fix16_t, fix16_div, fix16_t, fix16_t)
+#endif
+FIXMATH_WRAP1(fix16_t, fix16_recip, fix16_t)
+FIXMATH_WRAP1(fix16_divider_t, fix16_divider, fix16_t)
+FIXMATH_WRAP4_VOID(fix16_div_by_array, fix16_t *, const fix16_t *, uint32_t, const fix16_divider_t *)
+FIXMATH_WRAP2(fix16_t, fix16_mod, fix16_t, fix16_t)
+#ifndef FIXMATH_NO_64BIT
+FIXMATH_WRAP3(fix16_t, fix16_lerp8, fix16_t, fix16_t, uint8_t)
+FIXMATH_WRAP3(fix16_t, fix16_lerp16, fix16_t, fix16_t, uint16_t)
+FIXMATH_WRAP3(fix16_t, fix16_lerp32, fix16_t, fix16_t, uint32_t)
+#endif
+#endif
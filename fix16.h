@@ -6,12 +6,19 @@ extern "C"
 {
 #endif
 
+#include "libfixmath_conf.h"
+#include <stdint.h>
+
 /* These options may let the optimizer to remove some calls to the functions.
  * Refer to http://gcc.gnu.org/onlinedocs/gcc/Function-Attributes.html
+ * With FIXMATH_STICKY_OVERFLOW the functions write the overflow flag, so
+ * they are not const.
  */
 #ifndef FIXMATH_FUNC_ATTRS
 # ifdef __GNUC__
-#   if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ > 6)
+#   if defined(FIXMATH_STICKY_OVERFLOW)
+#     define FIXMATH_FUNC_ATTRS __attribute__((nothrow))
+#   elif __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ > 6)
 #     define FIXMATH_FUNC_ATTRS __attribute__((leaf, nothrow, const))
 #   else
 #     define FIXMATH_FUNC_ATTRS __attribute__((nothrow, const))
@@ -21,9 +28,6 @@ extern "C"
 # endif
 #endif
 
-#include "libfixmath_conf.h"
-#include <stdint.h>
-
 typedef int32_t fix16_t;
 
 static const fix16_t FOUR_DIV_PI  = 0x145F3;            /*!< Fix16 value of 4/PI */
@@ -40,6 +44,42 @@ static const fix16_t fix16_pi  = 205887;     /*!< fix16_t value of pi */
 static const fix16_t fix16_e   = 178145;     /*!< fix16_t value of e */
 static const fix16_t fix16_one = 0x00010000; /*!< fix16_t value of 1 */
 
+#ifdef FIXMATH_STICKY_OVERFLOW
+/* With FIXMATH_STICKY_OVERFLOW, operations which would return
+ * fix16_overflow (or fix8_overflow) return the saturated result instead, or
+ * fix16_minimum if there is none, e.g. for fix16_log2(0), and set a flag
+ * which stays set until cleared. A whole block of calculations can then run
+ * without comparing each result, and be checked once at the end:
+ *
+ *   fix16_overflow_clear();
+ *   ...
+ *   if (fix16_overflow_occurred()) ...
+ *
+ * The flag is per thread where the compiler supports it, see
+ * FIXMATH_THREAD_LOCAL in libfixmath_conf.h. Exact results of fix16_minimum
+ * may set it, where the check is done before the rounding, e.g. for
+ * fix16_div(fix16_minimum, fix16_one) and the FIXMATH_OPTIMIZE_8BIT
+ * multiplications.
+ */
+extern FIXMATH_THREAD_LOCAL uint8_t _fixmath_overflow_flag;
+
+/*! Returns nonzero if an operation overflowed since the last
+ * fix16_overflow_clear().
+ */
+static inline int fix16_overflow_occurred(void) { return _fixmath_overflow_flag; }
+
+/*! Clears the overflow flag.
+*/
+static inline void fix16_overflow_clear(void) { _fixmath_overflow_flag = 0; }
+
+#define _FIX16_OVERFLOW(negative) \
+	(_fixmath_overflow_flag = 1, (negative) ? fix16_minimum : fix16_maximum)
+#define _FIX16_SATURATE(negative) _FIX16_OVERFLOW(negative)
+#else
+#define _FIX16_OVERFLOW(negative) fix16_overflow
+#define _FIX16_SATURATE(negative) ((negative) ? fix16_minimum : fix16_maximum)
+#endif
+
 /* Conversion functions between fix16_t and float/integer.
  * These are inlined to allow compiler to optimize away constant numbers
  */
@@ -100,6 +140,20 @@ static inline fix16_t fix16_max(fix16_t x, fix16_t y)
 static inline fix16_t fix16_clamp(fix16_t x, fix16_t lo, fix16_t hi)
 	{ return fix16_min(fix16_max(x, lo), hi); }
 
+/* With FIXMATH_INLINE, fix16_add, fix16_sub and fix16_mul are static inline
+ * functions (see fix16_arith.h), which the compiler can inline and schedule
+ * in loops. Not for the 8-bit fix16_mul, where code size matters more, and
+ * not while profiling or tracing, which need the calls. The library and the
+ * application must be built with the same setting.
+ */
+#if defined(FIXMATH_INLINE) && !defined(FIXMATH_OPTIMIZE_8BIT) && \
+    !defined(FIXMATH_PROFILE) && !defined(FIXMATH_TRACE_OVERFLOW)
+#define FIX16_ARITH static inline
+#endif
+
+/* fix16_add_checked, fix16_sub_checked, fix16_mul_checked, fix16_div_checked. */
+#include "fix16_checked.h"
+
 /* Subtraction and addition with (optional) overflow detection. */
 #ifdef FIXMATH_NO_OVERFLOW
 
@@ -108,10 +162,12 @@ static inline fix16_t fix16_sub(fix16_t inArg0, fix16_t inArg1) { return (inArg0
 
 #else
 
+#ifndef FIX16_ARITH
 extern fix16_t fix16_add(fix16_t a, fix16_t b) FIXMATH_FUNC_ATTRS;
 extern fix16_t fix16_sub(fix16_t a, fix16_t b) FIXMATH_FUNC_ATTRS;
+#endif
 
-/* Saturating arithmetic */
+/* Saturating arithmetic, the same as the checked results */
 extern fix16_t fix16_sadd(fix16_t a, fix16_t b) FIXMATH_FUNC_ATTRS;
 extern fix16_t fix16_ssub(fix16_t a, fix16_t b) FIXMATH_FUNC_ATTRS;
 
@@ -119,12 +175,21 @@ extern fix16_t fix16_ssub(fix16_t a, fix16_t b) FIXMATH_FUNC_ATTRS;
 
 /*! Multiplies the two given fix16_t's and returns the result.
 */
+#ifdef FIX16_ARITH
+#include "fix16_arith.h"
+#else
 extern fix16_t fix16_mul(fix16_t inArg0, fix16_t inArg1) FIXMATH_FUNC_ATTRS;
+#endif
 
 /*! Divides the first given fix16_t by the second and returns the result.
 */
 extern fix16_t fix16_div(fix16_t inArg0, fix16_t inArg1) FIXMATH_FUNC_ATTRS;
 
+/*! Returns the reciprocal of the given fix16_t, faster than fix16_div. The
+ * same as fix16_div(fix16_one, inArg0) with FIXMATH_DIV64, i.e. exactly rounded.
+ */
+extern fix16_t fix16_recip(fix16_t inArg0) FIXMATH_FUNC_ATTRS;
+
 #ifndef FIXMATH_NO_OVERFLOW
 /*! Performs a saturated multiplication (overflow-protected) of the two given fix16_t's and returns the result.
 */
@@ -135,6 +200,264 @@ extern fix16_t fix16_smul(fix16_t inArg0, fix16_t inArg1) FIXMATH_FUNC_ATTRS;
 extern fix16_t fix16_sdiv(fix16_t inArg0, fix16_t inArg1) FIXMATH_FUNC_ATTRS;
 #endif
 
+/*! Precomputed division by one fix16_t, for dividing many values by the same
+ * divisor. fix16_divider() computes a reciprocal once, fix16_div_by() then
+ * multiplies by it instead of dividing, with the same result as fix16_div.
+ * The reciprocal rounds exactly, so for divisors of 16.0 and above, where
+ * the default and FIXMATH_NO_64BIT fix16_div do not, fix16_div_by calls
+ * fix16_div and is no faster. With FIXMATH_DIV64 or FIXMATH_OPTIMIZE_8BIT
+ * all divisors have a reciprocal.
+ */
+typedef struct {
+	uint32_t magic_hi;  /*!< 2^(49 + shift) / |divisor|, rounded up; 0 when */
+	uint32_t magic_lo;  /*!< fix16_div_by calls fix16_div instead */
+	uint8_t  shift;     /*!< ceil(log2(|divisor|)) */
+	fix16_t  divisor;
+} fix16_divider_t;
+
+/* High 32 bits of a * b, the low 32 bits in *lo, from 16*16->32 bit products. */
+static inline uint32_t _fix16_mul_hi(uint32_t a, uint32_t b, uint32_t *lo)
+{
+	uint32_t A = a >> 16, B = a & 0xFFFF, C = b >> 16, D = b & 0xFFFF;
+	uint32_t BD = B * D;
+	uint32_t mid1 = A * D, mid2 = B * C;
+	uint32_t hi = A * C + (mid1 >> 16) + (mid2 >> 16);
+	uint32_t low = BD + (mid1 << 16);
+	if (low < BD) hi++;
+	*lo = low + (mid2 << 16);
+	if (*lo < low) hi++;
+	return hi;
+}
+
+/*! Returns the divider dividing by the given fix16_t.
+*/
+extern fix16_divider_t fix16_divider(fix16_t divisor) FIXMATH_FUNC_ATTRS;
+
+/*! Divides the given fix16_t by the divisor of the divider, equal to
+ * fix16_div(inArg0, divisor).
+ */
+static inline fix16_t fix16_div_by(fix16_t inArg0, const fix16_divider_t *divider)
+{
+	// Zero, and on 32-bit targets large divisors, see fix16_divider().
+	if (!(divider->magic_hi | divider->magic_lo))
+		return fix16_div(inArg0, divider->divisor);
+
+	// (|a| << 17) / |divisor|, exact for all 32-bit |a|.
+	uint32_t remainder = (inArg0 >= 0) ? (uint32_t)inArg0 : -(uint32_t)inArg0;
+#if defined(FIXMATH_NO_64BIT)
+	// The same in 32-bit words, shift is at most 31.
+	uint32_t lo;
+	uint32_t carry = _fix16_mul_hi(remainder, divider->magic_lo, &lo);
+	uint32_t hi = _fix16_mul_hi(remainder, divider->magic_hi, &lo);
+	lo += carry;
+	hi += (lo < carry);
+	uint32_t quotient_hi = hi >> divider->shift;
+	uint32_t quotient = divider->shift ? (hi << (32 - divider->shift)) | (lo >> divider->shift) : lo;
+#else
+#ifdef __SIZEOF_INT128__
+	uint64_t magic = ((uint64_t)divider->magic_hi << 32) | divider->magic_lo;
+	uint64_t quotient64 = (uint64_t)(((unsigned __int128)remainder * magic) >> 32) >> divider->shift;
+#else
+	uint64_t lo = (uint64_t)remainder * divider->magic_lo;
+	uint64_t quotient64 = ((uint64_t)remainder * divider->magic_hi + (lo >> 32)) >> divider->shift;
+#endif
+	uint32_t quotient_hi = quotient64 >> 32;
+	uint32_t quotient = quotient64;
+#endif
+
+#ifndef FIXMATH_NO_OVERFLOW
+	if (quotient_hi)
+		return _FIX16_OVERFLOW((inArg0 ^ divider->divisor) < 0);
+#else
+	(void)quotient_hi;
+#endif
+
+#ifndef FIXMATH_NO_ROUNDING
+	quotient++;
+#endif
+	fix16_t result = quotient >> 1;
+
+	if ((inArg0 ^ divider->divisor) & 0x80000000)
+		result = -result;
+	return result;
+}
+
+/*! Divides count fix16_t's of in by the divisor of the divider into out,
+ * which may be the same array.
+ */
+extern void fix16_div_by_array(fix16_t *out, const fix16_t *in, uint32_t count, const fix16_divider_t *divider);
+
+/*! Divides a fix16_t by a positive integer constant with a multiply and a
+ * shift instead of a division, e.g. FIX16_DIV_CONST(x, 6). Rounds like
+ * fix16_div(x, fix16_from_int(n)) with FIXMATH_DIV64, i.e. exactly. The
+ * reciprocal is computed by the compiler, so n must be a constant
+ * expression. Evaluates n many times.
+ */
+#define FIX16_DIV_CONST(x, n) \
+	_fix16_div_const((x), (n), FIX16_DIV_CONST_MAGIC(n), FIX16_DIV_CONST_SHIFT(n), 1)
+
+/*! Same, but truncating toward zero like x / n in C, which saves a multiply.
+ */
+#define FIX16_DIV_CONST_TRUNC(x, n) \
+	_fix16_div_const((x), (n), FIX16_DIV_CONST_MAGIC(n), FIX16_DIV_CONST_SHIFT(n), 0)
+
+/* ceil(2^shift / n) with shift = 31 + bits of n - 1, so |x| * magic >> shift
+ * is |x| / n for all |x| <= 2^31. Both are constant expressions.
+ */
+#define FIX16_DIV_CONST_SHIFT(n) (31 + _FIX16_BITS32((uint32_t)(n) - 1))
+#define FIX16_DIV_CONST_MAGIC(n) \
+	((uint32_t)((((uint64_t)1 << FIX16_DIV_CONST_SHIFT(n)) + (n) - 1) / (n)))
+
+#define _FIX16_BITS2(x)  (((x) & 2) ? 2 : ((x) & 1))
+#define _FIX16_BITS4(x)  (((x) & 0xC) ? 2 + _FIX16_BITS2((x) >> 2) : _FIX16_BITS2(x))
+#define _FIX16_BITS8(x)  (((x) & 0xF0) ? 4 + _FIX16_BITS4((x) >> 4) : _FIX16_BITS4(x))
+#define _FIX16_BITS16(x) (((x) & 0xFF00) ? 8 + _FIX16_BITS8((x) >> 8) : _FIX16_BITS8(x))
+#define _FIX16_BITS32(x) (((x) & 0xFFFF0000) ? 16 + _FIX16_BITS16((x) >> 16) : _FIX16_BITS16(x))
+
+static inline fix16_t _fix16_div_const(fix16_t inArg0, uint32_t n, uint32_t magic, uint8_t shift, int round)
+{
+	// Branchless, the sign of the inputs is often random. |fix16_minimum| / 1
+	// comes out as fix16_minimum, which is fix16_overflow.
+	uint32_t sign = (uint32_t)(inArg0 >> 31);
+	uint32_t remainder = ((uint32_t)inArg0 ^ sign) - sign;
+#if defined(FIXMATH_NO_64BIT)
+	// The same in 32-bit words, shift is at least 31.
+	uint32_t lo;
+	uint32_t hi = _fix16_mul_hi(remainder, magic, &lo);
+	uint32_t quotient = (shift >= 32) ? hi >> (shift - 32) : (hi << 1) | (lo >> 31);
+#else
+	uint32_t quotient = ((uint64_t)remainder * magic) >> shift;
+#endif
+
+#ifndef FIXMATH_NO_ROUNDING
+	// Round half away from zero, as fix16_div does.
+	if (round)
+	{
+		remainder -= quotient * n;
+		quotient += (remainder >= n - remainder);
+	}
+#else
+	(void)n;
+	(void)round;
+#endif
+
+	return (quotient ^ sign) - sign;
+}
+
+/*! Accumulator for sums of products of fix16_t's, e.g. dot products and
+ * filter taps. It holds the exact sum in 32.32 format: fix16_mac() and
+ * fix16_msub() neither round nor check for overflow, fix16_acc_result()
+ * rounds and saturates once at the end. The partial sums may exceed the
+ * fix16_t range up to +-2^31. With FIXMATH_NO_64BIT it is a pair of 32-bit
+ * words, laid out like the emulated int64_t of int64.h.
+ */
+#ifndef FIXMATH_NO_64BIT
+typedef int64_t fix16_acc_t;
+
+/*! Returns an accumulator holding the given fix16_t, e.g. 0 or a bias.
+*/
+static inline fix16_acc_t fix16_acc_init(fix16_t inValue)
+	{ return (int64_t)inValue * fix16_one; }
+
+/*! Adds inArg0 * inArg1 to the accumulator and returns it.
+*/
+static inline fix16_acc_t fix16_mac(fix16_acc_t acc, fix16_t inArg0, fix16_t inArg1)
+	{ return acc + (int64_t)inArg0 * inArg1; }
+
+/*! Subtracts inArg0 * inArg1 from the accumulator and returns it.
+*/
+static inline fix16_acc_t fix16_msub(fix16_acc_t acc, fix16_t inArg0, fix16_t inArg1)
+	{ return acc - (int64_t)inArg0 * inArg1; }
+
+/*! Returns the accumulated sum, rounded like fix16_mul and saturated to
+ * fix16_minimum .. fix16_maximum.
+ */
+static inline fix16_t fix16_acc_result(fix16_acc_t acc)
+{
+	int64_t result = acc >> 16;
+#ifndef FIXMATH_NO_ROUNDING
+	// Round half away from zero, as fix16_mul does.
+	result += (((uint32_t)acc & 0xFFFF) + (acc >= 0)) > 0x8000;
+#endif
+#ifndef FIXMATH_NO_OVERFLOW
+	if (result > fix16_maximum || result < fix16_minimum)
+		return _FIX16_SATURATE(result < 0);
+#endif
+	return (fix16_t)result;
+}
+#else
+typedef struct {
+	 int32_t hi;
+	uint32_t lo;
+} fix16_acc_t;
+
+static inline fix16_acc_t fix16_acc_init(fix16_t inValue)
+{
+	fix16_acc_t acc = { inValue >> 16, (uint32_t)inValue << 16 };
+	return acc;
+}
+
+/* The exact 64-bit product, from 16*16->32 bit products of the magnitudes. */
+static inline fix16_acc_t _fix16_acc_product(fix16_t inArg0, fix16_t inArg1)
+{
+	uint32_t a = (inArg0 >= 0) ? (uint32_t)inArg0 : -(uint32_t)inArg0;
+	uint32_t b = (inArg1 >= 0) ? (uint32_t)inArg1 : -(uint32_t)inArg1;
+	uint32_t A = a >> 16, B = a & 0xFFFF, C = b >> 16, D = b & 0xFFFF;
+	uint32_t AD = A * D, BC = B * C;
+	uint32_t hi = A * C + (AD >> 16) + (BC >> 16);
+	uint32_t lo = B * D;
+	lo += AD << 16;
+	if (lo < (AD << 16)) hi++;
+	lo += BC << 16;
+	if (lo < (BC << 16)) hi++;
+
+	if ((inArg0 ^ inArg1) < 0)
+	{
+		hi = ~hi + (lo == 0);
+		lo = -lo;
+	}
+	fix16_acc_t product = { (int32_t)hi, lo };
+	return product;
+}
+
+static inline fix16_acc_t fix16_mac(fix16_acc_t acc, fix16_t inArg0, fix16_t inArg1)
+{
+	fix16_acc_t product = _fix16_acc_product(inArg0, inArg1);
+	uint32_t lo = acc.lo + product.lo;
+	acc.hi = (int32_t)((uint32_t)acc.hi + (uint32_t)product.hi + (lo < acc.lo));
+	acc.lo = lo;
+	return acc;
+}
+
+static inline fix16_acc_t fix16_msub(fix16_acc_t acc, fix16_t inArg0, fix16_t inArg1)
+{
+	fix16_acc_t product = _fix16_acc_product(inArg0, inArg1);
+	uint32_t lo = acc.lo - product.lo;
+	acc.hi = (int32_t)((uint32_t)acc.hi - (uint32_t)product.hi - (lo > acc.lo));
+	acc.lo = lo;
+	return acc;
+}
+
+static inline fix16_t fix16_acc_result(fix16_acc_t acc)
+{
+	int32_t hi = acc.hi;
+	uint32_t lo = acc.lo;
+#ifndef FIXMATH_NO_ROUNDING
+	if (((lo & 0xFFFF) + (hi >= 0)) > 0x8000)
+	{
+		lo += 0x10000;
+		if (lo < 0x10000)
+			hi = (int32_t)((uint32_t)hi + 1);
+	}
+#endif
+#ifndef FIXMATH_NO_OVERFLOW
+	if (hi > 0x7FFF || hi < -0x8000)
+		return _FIX16_SATURATE(hi < 0);
+#endif
+	return (fix16_t)(((uint32_t)hi << 16) | (lo >> 16));
+}
+#endif
+
 /*! Divides the first given fix16_t by the second and returns the result.
 */
 extern fix16_t fix16_mod(fix16_t x, fix16_t y) FIXMATH_FUNC_ATTRS;
@@ -229,6 +552,42 @@ extern void fix16_to_str(fix16_t value, char *buf, int decimals);
  */
 extern fix16_t fix16_from_str(const char *buf);
 
+#if defined(FIXMATH_CACHE_STATS) && !defined(FIXMATH_NO_CACHE)
+/* Cache statistics, for measuring whether the exp, sin and atan2 caches
+ * earn their RAM on a given workload. Only available when the library is
+ * built with FIXMATH_CACHE_STATS. The counters are not thread safe, and
+ * calls the compiler removed as duplicates (the functions are declared
+ * const) are not counted.
+ */
+typedef enum {
+	FIX16_CACHE_EXP,
+	FIX16_CACHE_SIN,
+	FIX16_CACHE_ATAN,
+	FIX16_CACHE_COUNT
+} fix16_cache_t;
+
+typedef struct {
+	uint32_t lookups;    /*!< calls which looked up the cache */
+	uint32_t hits;       /*!< lookups which found their input */
+	uint32_t collisions; /*!< misses on a slot holding another input, the
+	                          other misses are inputs seen for the first time */
+	uint32_t evictions;  /*!< stores replacing an input which had been hit,
+	                          i.e. useful entries lost to a collision */
+} fix16_cache_stats_t;
+
+/*! Copies the counters of the given cache to stats.
+ */
+extern void fix16_cache_stats(fix16_cache_t cache, fix16_cache_stats_t *stats);
+
+/*! Resets the counters of all caches. The cached values are kept.
+ */
+extern void fix16_cache_stats_reset(void);
+
+/* Used by the library functions to count cache accesses. */
+extern void _fix16_cache_lookup(fix16_cache_t cache, uint_fast16_t slot, int hit);
+extern void _fix16_cache_store(fix16_cache_t cache, uint_fast16_t slot);
+#endif
+
 #ifdef __cplusplus
 }
 #include "fix16.hpp"
@@ -0,0 +1,46 @@
+#ifndef __libfixmath_fix16_arith_h__
+#define __libfixmath_fix16_arith_h__
+
+/* fix16_add, fix16_sub and the 64-bit and 32-bit fix16_mul, built on the
+ * checked functions of fix16_checked.h. Compiled into fix16.c, or with
+ * FIXMATH_INLINE included by fix16.h as static inline functions, which
+ * FIX16_ARITH selects. Both are the same code, so the results do not depend
+ * on the option.
+ */
+
+/* Subtraction and addition with overflow detection.
+ * The versions without overflow detection are always inlined in fix16.h.
+ */
+#ifndef FIXMATH_NO_OVERFLOW
+FIX16_ARITH fix16_t fix16_add(fix16_t a, fix16_t b)
+{
+	fix16_t result;
+	if (fix16_add_checked(a, b, &result))
+		return _FIX16_OVERFLOW(a < 0);
+
+	return result;
+}
+
+FIX16_ARITH fix16_t fix16_sub(fix16_t a, fix16_t b)
+{
+	fix16_t result;
+	if (fix16_sub_checked(a, b, &result))
+		return _FIX16_OVERFLOW(a < 0);
+
+	return result;
+}
+#endif
+
+/* The 8-bit fix16_mul is in fix16.c. */
+#if !defined(FIXMATH_OPTIMIZE_8BIT)
+FIX16_ARITH fix16_t fix16_mul(fix16_t inArg0, fix16_t inArg1)
+{
+	fix16_t result;
+	if (fix16_mul_checked(inArg0, inArg1, &result))
+		return _FIX16_OVERFLOW(result < 0);
+
+	return result;
+}
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+#include "fix16.h"
+
+#if defined(FIXMATH_CACHE_STATS) && !defined(FIXMATH_NO_CACHE)
+
+#define CACHE_SIZE 4096
+#define CACHE_WORDS (CACHE_SIZE / 32)
+
+static fix16_cache_stats_t _fix16_cache_stats[FIX16_CACHE_COUNT];
+
+/* Per slot bits: written since startup, and hit since it was written. */
+static uint32_t _fix16_cache_used[FIX16_CACHE_COUNT][CACHE_WORDS];
+static uint32_t _fix16_cache_reused[FIX16_CACHE_COUNT][CACHE_WORDS];
+
+static inline int test_bit(const uint32_t *bits, uint_fast16_t slot)
+{
+	return (bits[slot >> 5] >> (slot & 31)) & 1;
+}
+
+void _fix16_cache_lookup(fix16_cache_t cache, uint_fast16_t slot, int hit)
+{
+	fix16_cache_stats_t *stats = &_fix16_cache_stats[cache];
+	stats->lookups++;
+	if (hit)
+	{
+		stats->hits++;
+		_fix16_cache_reused[cache][slot >> 5] |= (uint32_t)1 << (slot & 31);
+	}
+	else if (test_bit(_fix16_cache_used[cache], slot))
+	{
+		stats->collisions++;
+	}
+}
+
+void _fix16_cache_store(fix16_cache_t cache, uint_fast16_t slot)
+{
+	uint32_t bit = (uint32_t)1 << (slot & 31);
+	if (test_bit(_fix16_cache_reused[cache], slot))
+		_fix16_cache_stats[cache].evictions++;
+	_fix16_cache_used[cache][slot >> 5] |= bit;
+	_fix16_cache_reused[cache][slot >> 5] &= ~bit;
+}
+
+void fix16_cache_stats(fix16_cache_t cache, fix16_cache_stats_t *stats)
+{
+	*stats = _fix16_cache_stats[cache];
+}
+
+void fix16_cache_stats_reset(void)
+{
+	fix16_cache_stats_t zero = { 0, 0, 0, 0 };
+	uint_fast8_t i;
+	for (i = 0; i < FIX16_CACHE_COUNT; i++)
+		_fix16_cache_stats[i] = zero;
+}
+
+#endif
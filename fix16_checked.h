@@ -0,0 +1,189 @@
+#ifndef __libfixmath_fix16_checked_h__
+#define __libfixmath_fix16_checked_h__
+
+/* Checked arithmetic, included by fix16.h. fix16_add_checked, fix16_sub_checked,
+ * fix16_mul_checked and fix16_div_checked store the result in *result and
+ * return 0, or on overflow store the saturated result, fix16_minimum or
+ * fix16_maximum, and return nonzero. They do not set the flag of
+ * FIXMATH_STICKY_OVERFLOW, the caller is checking the result anyway.
+ * Overflow is reported exactly when fix16_add etc. report it, which includes
+ * some results of exactly fix16_minimum, see FIXMATH_STICKY_OVERFLOW.
+ *
+ * fix16_add, fix16_sub, fix16_mul and fix16_div are built on them, and the
+ * saturating fix16_sadd, fix16_ssub, fix16_smul and fix16_sdiv are the
+ * checked results with the flag ignored.
+ *
+ * Like the saturating functions they are not available with
+ * FIXMATH_NO_OVERFLOW, where the 64-bit and 32-bit fix16_mul_checked below
+ * are only used by fix16_mul and never report overflow.
+ */
+
+/* GCC 5 and later and Clang have overflow checking builtins, which compile
+ * to the overflow flag of the processor. FIXMATH_NO_OVERFLOW_BUILTINS
+ * selects the portable sign bit tests instead.
+ */
+#if defined(__GNUC__) && !defined(FIXMATH_NO_OVERFLOW_BUILTINS) && !defined(FIXMATH_OVERFLOW_BUILTINS)
+# if defined(__has_builtin)
+#   if __has_builtin(__builtin_add_overflow) && __has_builtin(__builtin_mul_overflow)
+#     define FIXMATH_OVERFLOW_BUILTINS
+#   endif
+# elif __GNUC__ >= 5
+#   define FIXMATH_OVERFLOW_BUILTINS
+# endif
+#endif
+
+/* Stores the saturated result of an overflowing operation and returns 1. */
+static inline int _fix16_overflowed(fix16_t *result, int negative)
+{
+	*result = negative ? fix16_minimum : fix16_maximum;
+	return 1;
+}
+
+#ifndef FIXMATH_NO_OVERFLOW
+/*! Adds the two given fix16_t's, returns nonzero on overflow.
+*/
+static inline int fix16_add_checked(fix16_t a, fix16_t b, fix16_t *result)
+{
+	fix16_t sum;
+#ifdef FIXMATH_OVERFLOW_BUILTINS
+	int overflow = __builtin_add_overflow(a, b, &sum);
+#else
+	// Overflow can only happen if sign of a == sign of b, and then
+	// it causes sign of sum != sign of a.
+	uint32_t _a = a, _b = b;
+	sum = _a + _b;
+	int overflow = ((_a ^ sum) & (_b ^ sum)) >> 31;
+#endif
+	// Both sides are computed so that this is a conditional move, and
+	// fix16_maximum ^ (a >> 31) saturates to the sign of a.
+	*result = overflow ? (fix16_maximum ^ (a >> 31)) : sum;
+	return overflow;
+}
+
+/*! Subtracts the second given fix16_t from the first, returns nonzero on overflow.
+*/
+static inline int fix16_sub_checked(fix16_t a, fix16_t b, fix16_t *result)
+{
+	fix16_t diff;
+#ifdef FIXMATH_OVERFLOW_BUILTINS
+	int overflow = __builtin_sub_overflow(a, b, &diff);
+#else
+	// Overflow can only happen if sign of a != sign of b, and then
+	// it causes sign of diff != sign of a.
+	uint32_t _a = a, _b = b;
+	diff = _a - _b;
+	int overflow = ((_a ^ _b) & (_a ^ diff)) >> 31;
+#endif
+	*result = overflow ? (fix16_maximum ^ (a >> 31)) : diff;
+	return overflow;
+}
+#endif
+
+/* 64-bit implementation of fix16_mul_checked. Fastest version for e.g. ARM
+ * Cortex M3. Performs a 32*32 -> 64bit multiplication, rounds it and checks
+ * that the middle 32 bits are the result.
+ */
+#if !defined(FIXMATH_NO_64BIT) && !defined(FIXMATH_OPTIMIZE_8BIT)
+/*! Multiplies the two given fix16_t's, returns nonzero on overflow.
+*/
+static inline int fix16_mul_checked(fix16_t inArg0, fix16_t inArg1, fix16_t *result)
+{
+	int64_t product = (int64_t)inArg0 * inArg1;
+
+	#ifndef FIXMATH_NO_ROUNDING
+	// Round half away from zero, which for -1/2 needs one less.
+	product += 0x8000 - (product < 0);
+	#endif
+	product >>= 16;
+
+	#ifdef FIXMATH_NO_OVERFLOW
+	*result = product;
+	return 0;
+	#else
+	fix16_t low;
+	#ifdef FIXMATH_OVERFLOW_BUILTINS
+	// Adding 0 checks the conversion of the product to 32 bits.
+	int overflow = __builtin_add_overflow(product, 0, &low);
+	#else
+	low = (uint32_t)product;
+	int overflow = (product != low);
+	#endif
+	*result = overflow ? (fix16_maximum ^ (fix16_t)(product >> 63)) : low;
+	return overflow;
+	#endif
+}
+#endif
+
+/* 32-bit implementation of fix16_mul_checked. Potentially fast on 16-bit
+ * processors, and this is a relatively good compromise for compilers that do
+ * not support uint64_t. Uses 16*16->32bit multiplications.
+ */
+#if defined(FIXMATH_NO_64BIT) && !defined(FIXMATH_OPTIMIZE_8BIT)
+static inline int fix16_mul_checked(fix16_t inArg0, fix16_t inArg1, fix16_t *result)
+{
+	// Each argument is divided to 16-bit parts.
+	//					AB
+	//			*	 CD
+	// -----------
+	//					BD	16 * 16 -> 32 bit products
+	//				 CB
+	//				 AD
+	//				AC
+	//			 |----| 64 bit product
+	int32_t A = (inArg0 >> 16), C = (inArg1 >> 16);
+	uint32_t B = (inArg0 & 0xFFFF), D = (inArg1 & 0xFFFF);
+
+	int32_t AC = A*C;
+	int32_t AD_CB = A*D + C*B;
+	uint32_t BD = B*D;
+
+	int32_t product_hi = AC + (AD_CB >> 16);
+
+	// Handle carry from lower 32 bits to upper part of result.
+	uint32_t ad_cb_temp = AD_CB << 16;
+	uint32_t product_lo = BD + ad_cb_temp;
+	if (product_lo < BD)
+		product_hi++;
+
+#ifndef FIXMATH_NO_OVERFLOW
+	// The upper 17 bits should all be the same (the sign).
+	if (product_hi >> 31 != product_hi >> 15)
+		return _fix16_overflowed(result, product_hi < 0);
+#endif
+
+#ifdef FIXMATH_NO_ROUNDING
+	*result = (product_hi << 16) | (product_lo >> 16);
+#else
+	// Subtracting 0x8000 (= 0.5) and then using signed right shift
+	// achieves proper rounding to result-1, except in the corner
+	// case of negative numbers and lowest word = 0x8000.
+	// To handle that, we also have to subtract 1 for negative numbers.
+	uint32_t product_lo_tmp = product_lo;
+	product_lo -= 0x8000;
+	product_lo -= (uint32_t)product_hi >> 31;
+	if (product_lo > product_lo_tmp)
+		product_hi--;
+
+	// Discard the lowest 16 bits. Note that this is not exactly the same
+	// as dividing by 0x10000. For example if product = -1, result will
+	// also be -1 and not 0. This is compensated by adding +1 to the result
+	// and compensating this in turn in the rounding above.
+	*result = ((product_hi << 16) | (product_lo >> 16)) + 1;
+#endif
+	return 0;
+}
+#endif
+
+#ifndef FIXMATH_NO_OVERFLOW
+/* 8-bit implementation of fix16_mul_checked, in fix16.c. */
+#if defined(FIXMATH_OPTIMIZE_8BIT)
+extern int fix16_mul_checked(fix16_t inArg0, fix16_t inArg1, fix16_t *result);
+#endif
+
+/*! Divides the first given fix16_t by the second, returns nonzero on
+ * overflow and for division by zero.
+ */
+extern int fix16_div_checked(fix16_t a, fix16_t b, fix16_t *result);
+#endif
+
+#endif
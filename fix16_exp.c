@@ -1,3 +1,4 @@
+#include "fixmath_wrap.h"
 #include "fix16.h"
 #include <stdbool.h>
 
@@ -6,6 +7,26 @@ static fix16_t _fix16_exp_cache_index[4096]  = { 0 };
 static fix16_t _fix16_exp_cache_value[4096]  = { 0 };
 #endif
 
+#ifndef FIXMATH_OPTIMIZE_8BIT
+/* Reciprocals for dividing by the term index of the power series, see
+ * FIX16_DIV_CONST. Not on AVR, where the tables would take RAM.
+ */
+#define M(n) FIX16_DIV_CONST_MAGIC(n)
+#define S(n) FIX16_DIV_CONST_SHIFT(n)
+static const uint32_t _fix16_exp_div_magic[30] = {
+	0,      0,      M(2),  M(3),  M(4),  M(5),  M(6),  M(7),  M(8),  M(9),
+	M(10),  M(11),  M(12), M(13), M(14), M(15), M(16), M(17), M(18), M(19),
+	M(20),  M(21),  M(22), M(23), M(24), M(25), M(26), M(27), M(28), M(29)
+};
+static const uint8_t _fix16_exp_div_shift[30] = {
+	0,      0,      S(2),  S(3),  S(4),  S(5),  S(6),  S(7),  S(8),  S(9),
+	S(10),  S(11),  S(12), S(13), S(14), S(15), S(16), S(17), S(18), S(19),
+	S(20),  S(21),  S(22), S(23), S(24), S(25), S(26), S(27), S(28), S(29)
+};
+#undef M
+#undef S
+#endif
+
 
 
 fix16_t fix16_exp(fix16_t inValue) {
@@ -17,6 +38,9 @@ fix16_t fix16_exp(fix16_t inValue) {
 	#ifndef FIXMATH_NO_CACHE
 	fix16_t tempIndex = (inValue ^ (inValue >> 16));
 	tempIndex = (inValue ^ (inValue >> 4)) & 0x0FFF;
+	#ifdef FIXMATH_CACHE_STATS
+	_fix16_cache_lookup(FIX16_CACHE_EXP, tempIndex, _fix16_exp_cache_index[tempIndex] == inValue);
+	#endif
 	if(_fix16_exp_cache_index[tempIndex] == inValue)
 		return _fix16_exp_cache_value[tempIndex];
 	#endif
@@ -39,18 +63,25 @@ fix16_t fix16_exp(fix16_t inValue) {
 	uint_fast8_t i;        
 	for (i = 2; i < 30; i++)
 	{
+		#ifndef FIXMATH_OPTIMIZE_8BIT
+		term = fix16_mul(term, _fix16_div_const(inValue, i, _fix16_exp_div_magic[i], _fix16_exp_div_shift[i], 1));
+		#else
 		term = fix16_mul(term, fix16_div(inValue, fix16_from_int(i)));
+		#endif
 		result += term;
                 
 		if ((term < 500) && ((i > 15) || (term < 20)))
 			break;
 	}
             
-	if (neg) result = fix16_div(fix16_one, result);
+	if (neg) result = fix16_recip(result);
             
 	#ifndef FIXMATH_NO_CACHE
 	_fix16_exp_cache_index[tempIndex] = inValue;
 	_fix16_exp_cache_value[tempIndex] = result;
+	#ifdef FIXMATH_CACHE_STATS
+	_fix16_cache_store(FIX16_CACHE_EXP, tempIndex);
+	#endif
 	#endif
 
 	return result;
@@ -66,7 +97,7 @@ fix16_t fix16_log(fix16_t inValue)
 	int count = 0;
 	
 	if (inValue <= 0)
-		return fix16_minimum;
+		return _FIX16_OVERFLOW(1);
 	
 	// Bring the value to the most accurate range (1 < x < 100)
 	const fix16_t e_to_fourth = 3578144;
@@ -167,7 +198,7 @@ fix16_t fix16_log2(fix16_t x)
 	// Note that a negative x gives a non-real result.
 	// If x == 0, the limit of log2(x)  as x -> 0 = -infinity.
 	// log2(-ve) gives a complex result.
-	if (x <= 0) return fix16_overflow;
+	if (x <= 0) return _FIX16_OVERFLOW(1);
 
 	// If the input is less than one, the result is -log2(1.0 / in)
 	if (x < fix16_one)
@@ -176,7 +207,7 @@ fix16_t fix16_log2(fix16_t x)
 		// This is the exact answer for log2(1.0 / 65536)
 		if (x == 1) return fix16_from_int(-16);
 
-		fix16_t inverse = fix16_div(fix16_one, x);
+		fix16_t inverse = fix16_recip(x);
 		return -fix16__log2_inner(inverse);
 	}
 
@@ -196,3 +227,14 @@ fix16_t fix16_slog2(fix16_t x)
 		return fix16_minimum;
 	return retval;
 }
+
+#ifdef FIXMATH_WRAP
+#undef fix16_exp
+#undef fix16_log
+#undef fix16_log2
+#undef fix16_slog2
+FIXMATH_WRAP1(fix16_t, fix16_exp, fix16_t)
+FIXMATH_WRAP1(fix16_t, fix16_log, fix16_t)
+FIXMATH_WRAP1(fix16_t, fix16_log2, fix16_t)
+FIXMATH_WRAP1(fix16_t, fix16_slog2, fix16_t)
+#endif
@@ -0,0 +1,8 @@
+/* fix16.c without overflow detection (FIXMATH_NO_OVERFLOW), as
+ * fix16_no_mul etc., see fix16_variant.h.
+ */
+#define FIXMATH_VARIANT no
+#ifndef FIXMATH_NO_OVERFLOW
+#define FIXMATH_NO_OVERFLOW
+#endif
+#include "fix16.c"
@@ -0,0 +1,8 @@
+/* fix16.c without rounding (FIXMATH_NO_ROUNDING), as fix16_nr_mul etc.,
+ * see fix16_variant.h.
+ */
+#define FIXMATH_VARIANT nr
+#ifndef FIXMATH_NO_ROUNDING
+#define FIXMATH_NO_ROUNDING
+#endif
+#include "fix16.c"
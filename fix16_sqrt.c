@@ -1,3 +1,4 @@
+#include "fixmath_wrap.h"
 #include "fix16.h"
 
 /* The square root algorithm is quite directly from
@@ -82,3 +83,8 @@ fix16_t fix16_sqrt(fix16_t inValue)
 	
 	return (neg ? -(fix16_t)result : (fix16_t)result);
 }
+
+#ifdef FIXMATH_WRAP
+#undef fix16_sqrt
+FIXMATH_WRAP1(fix16_t, fix16_sqrt, fix16_t)
+#endif
@@ -1,3 +1,4 @@
+#include "fixmath_wrap.h"
 #include "fix16.h"
 #include <stdbool.h>
 #include <ctype.h>
@@ -79,7 +80,7 @@ fix16_t fix16_from_str(const char *buf)
     
     if (count == 0 || count > 5
         || intpart > 32768 || (!negative && intpart > 32767))
-        return fix16_overflow;
+        return _FIX16_OVERFLOW(negative || count == 0);
     
     fix16_t value = intpart << 16;
     
@@ -104,7 +105,7 @@ fix16_t fix16_from_str(const char *buf)
     while (*buf != '\0')
     {
         if (!isdigit(*buf) && !isspace(*buf))
-            return fix16_overflow;
+            return _FIX16_OVERFLOW(1);
         
         buf++;
     }
@@ -112,3 +113,9 @@ fix16_t fix16_from_str(const char *buf)
     return negative ? -value : value;
 }
 
+#ifdef FIXMATH_WRAP
+#undef fix16_to_str
+#undef fix16_from_str
+FIXMATH_WRAP3_VOID(fix16_to_str, fix16_t, char *, int)
+FIXMATH_WRAP1(fix16_t, fix16_from_str, const char *)
+#endif
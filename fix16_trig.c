@@ -1,4 +1,5 @@
 #include <limits.h>
+#include "fixmath_wrap.h"
 #include "fix16.h"
 
 #if defined(FIXMATH_SIN_LUT)
@@ -8,6 +9,29 @@ static fix16_t _fix16_sin_cache_index[4096]  = { 0 };
 static fix16_t _fix16_sin_cache_value[4096]  = { 0 };
 #endif
 
+/* fix16_mul and fix16_div for intermediate results which may overflow,
+ * e.g. the x^11 term of fix16_sin for |x| > 2.57. With
+ * FIXMATH_STICKY_OVERFLOW they return fix16_overflow as the other builds
+ * do and leave the flag alone, so that the results stay the same and the
+ * flag only tells about overflowed results of the application's calls.
+ */
+#ifdef FIXMATH_STICKY_OVERFLOW
+static inline fix16_t _fix16_trig_mul(fix16_t inArg0, fix16_t inArg1)
+{
+	fix16_t result;
+	return fix16_mul_checked(inArg0, inArg1, &result) ? fix16_overflow : result;
+}
+
+static inline fix16_t _fix16_trig_div(fix16_t inArg0, fix16_t inArg1)
+{
+	fix16_t result;
+	return fix16_div_checked(inArg0, inArg1, &result) ? fix16_overflow : result;
+}
+#else
+#define _fix16_trig_mul fix16_mul
+#define _fix16_trig_div fix16_div
+#endif
+
 #ifndef FIXMATH_NO_CACHE
 static fix16_t _fix16_atan_cache_index[2][4096] = { { 0 }, { 0 } };
 static fix16_t _fix16_atan_cache_value[4096] = { 0 };
@@ -71,6 +95,9 @@ fix16_t fix16_sin(fix16_t inAngle)
 
 	#ifndef FIXMATH_NO_CACHE
 	fix16_t tempIndex = ((inAngle >> 5) & 0x00000FFF);
+	#ifdef FIXMATH_CACHE_STATS
+	_fix16_cache_lookup(FIX16_CACHE_SIN, tempIndex, _fix16_sin_cache_index[tempIndex] == inAngle);
+	#endif
 	if(_fix16_sin_cache_index[tempIndex] == inAngle)
 		return _fix16_sin_cache_value[tempIndex];
 	#endif
@@ -79,16 +106,16 @@ fix16_t fix16_sin(fix16_t inAngle)
 
 	#ifndef FIXMATH_FAST_SIN // Most accurate version, accurate to ~2.1%
 	fix16_t tempOut = tempAngle;
-	tempAngle = fix16_mul(tempAngle, tempAngleSq);
-	tempOut -= (tempAngle / 6);
-	tempAngle = fix16_mul(tempAngle, tempAngleSq);
-	tempOut += (tempAngle / 120);
-	tempAngle = fix16_mul(tempAngle, tempAngleSq);
-	tempOut -= (tempAngle / 5040);
-	tempAngle = fix16_mul(tempAngle, tempAngleSq);
-	tempOut += (tempAngle / 362880);
-	tempAngle = fix16_mul(tempAngle, tempAngleSq);
-	tempOut -= (tempAngle / 39916800);
+	tempAngle = _fix16_trig_mul(tempAngle, tempAngleSq);
+	tempOut -= FIX16_DIV_CONST_TRUNC(tempAngle, 6);
+	tempAngle = _fix16_trig_mul(tempAngle, tempAngleSq);
+	tempOut += FIX16_DIV_CONST_TRUNC(tempAngle, 120);
+	tempAngle = _fix16_trig_mul(tempAngle, tempAngleSq);
+	tempOut -= FIX16_DIV_CONST_TRUNC(tempAngle, 5040);
+	tempAngle = _fix16_trig_mul(tempAngle, tempAngleSq);
+	tempOut += FIX16_DIV_CONST_TRUNC(tempAngle, 362880);
+	tempAngle = _fix16_trig_mul(tempAngle, tempAngleSq);
+	tempOut -= FIX16_DIV_CONST_TRUNC(tempAngle, 39916800);
 	#else // Fast implementation, runs at 159% the speed of above 'accurate' version with an slightly lower accuracy of ~2.3%
 	fix16_t tempOut;
 	tempOut = fix16_mul(-13, tempAngleSq) + 546;
@@ -100,6 +127,9 @@ fix16_t fix16_sin(fix16_t inAngle)
 	#ifndef FIXMATH_NO_CACHE
 	_fix16_sin_cache_index[tempIndex] = inAngle;
 	_fix16_sin_cache_value[tempIndex] = tempOut;
+	#ifdef FIXMATH_CACHE_STATS
+	_fix16_cache_store(FIX16_CACHE_SIN, tempIndex);
+	#endif
 	#endif
 	#endif
 
@@ -113,7 +143,11 @@ fix16_t fix16_cos(fix16_t inAngle)
 
 fix16_t fix16_tan(fix16_t inAngle)
 {
+	#ifndef FIXMATH_NO_OVERFLOW
 	return fix16_sdiv(fix16_sin(inAngle), fix16_cos(inAngle));
+	#else
+	return fix16_div(fix16_sin(inAngle), fix16_cos(inAngle));
+	#endif
 }
 
 fix16_t fix16_asin(fix16_t x)
@@ -124,7 +158,7 @@ fix16_t fix16_asin(fix16_t x)
 
 	fix16_t out;
 	out = (fix16_one - fix16_mul(x, x));
-	out = fix16_div(x, fix16_sqrt(out));
+	out = _fix16_trig_div(x, fix16_sqrt(out));
 	out = fix16_atan(out);
 	return out;
 }
@@ -142,6 +176,10 @@ fix16_t fix16_atan2(fix16_t inY , fix16_t inX)
 	uintptr_t hash = (inX ^ inY);
 	hash ^= hash >> 20;
 	hash &= 0x0FFF;
+	#ifdef FIXMATH_CACHE_STATS
+	_fix16_cache_lookup(FIX16_CACHE_ATAN, hash,
+		(_fix16_atan_cache_index[0][hash] == inX) && (_fix16_atan_cache_index[1][hash] == inY));
+	#endif
 	if((_fix16_atan_cache_index[0][hash] == inX) && (_fix16_atan_cache_index[1][hash] == inY))
 		return _fix16_atan_cache_value[hash];
 	#endif
@@ -171,6 +209,9 @@ fix16_t fix16_atan2(fix16_t inY , fix16_t inX)
 	_fix16_atan_cache_index[0][hash] = inX;
 	_fix16_atan_cache_index[1][hash] = inY;
 	_fix16_atan_cache_value[hash] = angle;
+	#ifdef FIXMATH_CACHE_STATS
+	_fix16_cache_store(FIX16_CACHE_ATAN, hash);
+	#endif
 	#endif
 
 	return angle;
@@ -180,3 +221,22 @@ fix16_t fix16_atan(fix16_t x)
 {
 	return fix16_atan2(x, fix16_one);
 }
+
+#ifdef FIXMATH_WRAP
+#undef fix16_sin_parabola
+#undef fix16_sin
+#undef fix16_cos
+#undef fix16_tan
+#undef fix16_asin
+#undef fix16_acos
+#undef fix16_atan
+#undef fix16_atan2
+FIXMATH_WRAP1(fix16_t, fix16_sin_parabola, fix16_t)
+FIXMATH_WRAP1(fix16_t, fix16_sin, fix16_t)
+FIXMATH_WRAP1(fix16_t, fix16_cos, fix16_t)
+FIXMATH_WRAP1(fix16_t, fix16_tan, fix16_t)
+FIXMATH_WRAP1(fix16_t, fix16_asin, fix16_t)
+FIXMATH_WRAP1(fix16_t, fix16_acos, fix16_t)
+FIXMATH_WRAP1(fix16_t, fix16_atan, fix16_t)
+FIXMATH_WRAP2(fix16_t, fix16_atan2, fix16_t, fix16_t)
+#endif
@@ -0,0 +1,59 @@
+#ifndef __libfixmath_fix16_variant_h__
+#define __libfixmath_fix16_variant_h__
+
+#include "fix16.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Variants of the fix16.c functions, built from the same source with one
+ * more FIXMATH_* option and linked next to the default ones, so that each
+ * part of a program can call the cheapest one it tolerates:
+ *
+ *   fix16_nr_mul etc.  FIXMATH_NO_ROUNDING (fix16_nr.c)
+ *   fix16_no_mul etc.  FIXMATH_NO_OVERFLOW (fix16_no.c)
+ *
+ * All other options are those of the library build. Further variants are
+ * a source file like fix16_nr.c, which defines FIXMATH_VARIANT to the prefix
+ * and the options and includes fix16.c, and a FIX16_VARIANT_DECLARE line
+ * here.
+ *
+ * FIX16_VARIANT_DECLARE declares the functions of a variant with overflow
+ * detection, FIX16_VARIANT_DECLARE_NO_OVERFLOW of one without, where add
+ * and sub are inline as in fix16.h.
+ */
+#define FIX16_VARIANT_DECLARE_COMMON(prefix) \
+	extern fix16_t fix16_##prefix##_mul(fix16_t inArg0, fix16_t inArg1) FIXMATH_FUNC_ATTRS; \
+	extern fix16_t fix16_##prefix##_div(fix16_t inArg0, fix16_t inArg1) FIXMATH_FUNC_ATTRS; \
+	extern fix16_t fix16_##prefix##_recip(fix16_t inArg0) FIXMATH_FUNC_ATTRS; \
+	extern fix16_t fix16_##prefix##_mod(fix16_t x, fix16_t y) FIXMATH_FUNC_ATTRS;
+
+#define FIX16_VARIANT_DECLARE(prefix) \
+	FIX16_VARIANT_DECLARE_COMMON(prefix) \
+	extern fix16_t fix16_##prefix##_add(fix16_t a, fix16_t b) FIXMATH_FUNC_ATTRS; \
+	extern fix16_t fix16_##prefix##_sub(fix16_t a, fix16_t b) FIXMATH_FUNC_ATTRS; \
+	extern fix16_t fix16_##prefix##_sadd(fix16_t a, fix16_t b) FIXMATH_FUNC_ATTRS; \
+	extern fix16_t fix16_##prefix##_ssub(fix16_t a, fix16_t b) FIXMATH_FUNC_ATTRS; \
+	extern fix16_t fix16_##prefix##_smul(fix16_t inArg0, fix16_t inArg1) FIXMATH_FUNC_ATTRS; \
+	extern fix16_t fix16_##prefix##_sdiv(fix16_t inArg0, fix16_t inArg1) FIXMATH_FUNC_ATTRS; \
+	extern int fix16_##prefix##_div_checked(fix16_t a, fix16_t b, fix16_t *result);
+
+#define FIX16_VARIANT_DECLARE_NO_OVERFLOW(prefix) \
+	FIX16_VARIANT_DECLARE_COMMON(prefix) \
+	static inline fix16_t fix16_##prefix##_add(fix16_t inArg0, fix16_t inArg1) { return (inArg0 + inArg1); } \
+	static inline fix16_t fix16_##prefix##_sub(fix16_t inArg0, fix16_t inArg1) { return (inArg0 - inArg1); }
+
+#ifdef FIXMATH_NO_OVERFLOW
+FIX16_VARIANT_DECLARE_NO_OVERFLOW(nr)
+#else
+FIX16_VARIANT_DECLARE(nr)
+#endif
+FIX16_VARIANT_DECLARE_NO_OVERFLOW(no)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,3 +1,4 @@
+#include "fixmath_wrap.h"
 #include "fix8.h"
 #if !defined(FIXMATH_NO_64BIT)
 #include "int64.h"
@@ -18,7 +19,7 @@ fix8_t fix8_add(fix8_t a, fix8_t b)
 	// Overflow can only happen if sign of a == sign of b, and then
 	// it causes sign of sum != sign of a.
 	if (!((_a ^ _b) & 0x8000) && ((_a ^ sum) & 0x8000))
-		return fix8_overflow;
+		return _FIX8_OVERFLOW(a < 0);
 	
 	return sum;
 }
@@ -31,7 +32,7 @@ fix8_t fix8_sub(fix8_t a, fix8_t b)
 	// Overflow can only happen if sign of a != sign of b, and then
 	// it causes sign of diff != sign of a.
 	if (((_a ^ _b) & 0x8000) && ((_a ^ diff) & 0x8000))
-		return fix8_overflow;
+		return _FIX8_OVERFLOW(a < 0);
 	
 	return diff;
 }
@@ -41,8 +42,11 @@ fix8_t fix8_sadd(fix8_t a, fix8_t b)
 {
 	fix8_t result = fix8_add(a, b);
 
+	// With FIXMATH_STICKY_OVERFLOW the result is already saturated.
+	#ifndef FIXMATH_STICKY_OVERFLOW
 	if (result == fix8_overflow)
 		return (a >= 0) ? fix8_maximum : fix8_minimum;
+	#endif
 
 	return result;
 }	
@@ -51,8 +55,11 @@ fix8_t fix8_ssub(fix8_t a, fix8_t b)
 {
 	fix8_t result = fix8_sub(a, b);
 
+	// With FIXMATH_STICKY_OVERFLOW the result is already saturated.
+	#ifndef FIXMATH_STICKY_OVERFLOW
 	if (result == fix8_overflow)
 		return (a >= 0) ? fix8_maximum : fix8_minimum;
+	#endif
 
 	return result;
 }
@@ -118,7 +125,7 @@ fix8_t fix8_mul(fix8_t inArg0, fix8_t inArg1)
 
 	#ifndef FIXMATH_NO_OVERFLOW
 	// i = 6
-	if (va[1] && vb[1]) return fix8_overflow;
+	if (va[1] && vb[1]) return _FIX8_OVERFLOW((inArg0 ^ inArg1) < 0);
 	#endif
 
   // x * y = 65536 * x1 * y1 + 256 * x1 * y0 + 256 * x0 * y1 + x0 * y0
@@ -139,7 +146,7 @@ fix8_t fix8_mul(fix8_t inArg0, fix8_t inArg1)
   
 	#ifndef FIXMATH_NO_OVERFLOW
 	if (low & 0x8000)
-		return fix8_overflow;
+		return _FIX8_OVERFLOW((inArg0 ^ inArg1) < 0);
 	#endif
 	
 	fix8_t result = low;
@@ -161,6 +168,7 @@ fix8_t fix8_smul(fix8_t inArg0, fix8_t inArg1)
 {
 	fix8_t result = fix8_mul(inArg0, inArg1);
 	
+	#ifndef FIXMATH_STICKY_OVERFLOW
 	if (result == fix8_overflow)
 	{
 		if ((inArg0 >= 0) == (inArg1 >= 0))
@@ -168,6 +176,7 @@ fix8_t fix8_smul(fix8_t inArg0, fix8_t inArg1)
 		else
 			return fix8_minimum;
 	}
+	#endif
 	
 	return result;
 }
@@ -186,7 +195,7 @@ fix8_t fix8_div(fix8_t a, fix8_t b)
 	// platforms without hardware divide.
 	
 	if (b == 0)
-		return fix8_minimum;
+		return _FIX8_OVERFLOW(a < 0);
 	
 	uint16_t remainder = (a >= 0) ? a : (-a);
 	uint16_t divider = (b >= 0) ? b : (-b);
@@ -203,7 +212,7 @@ fix8_t fix8_div(fix8_t a, fix8_t b)
 	
 	#ifndef FIXMATH_NO_OVERFLOW
 	if (!bit)
-		return fix8_overflow;
+		return _FIX8_OVERFLOW((a ^ b) < 0);
 	#endif
 	
 	if (divider & 0x8000)
@@ -239,20 +248,19 @@ fix8_t fix8_div(fix8_t a, fix8_t b)
 	}
 	#endif
 	
-	fix8_t result = quotient;
+	#ifndef FIXMATH_NO_OVERFLOW
+	// Only a negative result, fix8_minimum, can have the highest bit set.
+	if (quotient > (uint16_t)fix8_maximum + ((a ^ b) < 0))
+		return _FIX8_OVERFLOW((a ^ b) < 0);
+	#endif
 	
-	/* Figure out the sign of result */
+	/* Figure out the sign of result. A negated 0x8000 is
+	 * fix8_minimum, which is not an overflow.
+	 */
 	if ((a ^ b) & 0x8000)
-	{
-		#ifndef FIXMATH_NO_OVERFLOW
-		if (result == fix8_minimum)
-				return fix8_overflow;
-		#endif
-		
-		result = -result;
-	}
+		quotient = -quotient;
 	
-	return result;
+	return quotient;
 }
 #endif
 
@@ -262,6 +270,7 @@ fix8_t fix8_sdiv(fix8_t inArg0, fix8_t inArg1)
 {
 	fix8_t result = fix8_div(inArg0, inArg1);
 	
+	#ifndef FIXMATH_STICKY_OVERFLOW
 	if (result == fix8_overflow)
 	{
 		if ((inArg0 >= 0) == (inArg1 >= 0))
@@ -269,6 +278,7 @@ fix8_t fix8_sdiv(fix8_t inArg0, fix8_t inArg1)
 		else
 			return fix8_minimum;
 	}
+	#endif
 	
 	return result;
 }
@@ -321,3 +331,39 @@ fix8_t fix8_lerp32(fix8_t inArg0, fix8_t inArg1, uint32_t inFract)
 	return (fix8_t)tempOut;
 }
 #endif
+
+#ifdef FIXMATH_WRAP
+#undef fix8_add
+#undef fix8_sub
+#undef fix8_sadd
+#undef fix8_ssub
+#undef fix8_mul
+#undef fix8_div
+#undef fix8_smul
+#undef fix8_sdiv
+#undef fix8_mod
+#undef fix8_lerp8
+#undef fix8_lerp16
+#undef fix8_lerp32
+#ifndef FIXMATH_NO_OVERFLOW
+FIXMATH_WRAP2_OVERFLOW(fix8_t, fix8_add, FIXMATH_OP_FIX8_ADD, fix8_overflow)
+FIXMATH_WRAP2_OVERFLOW(fix8_t, fix8_sub, FIXMATH_OP_FIX8_SUB, fix8_overflow)
+FIXMATH_WRAP2(fix8_t, fix8_sadd, fix8_t, fix8_t)
+FIXMATH_WRAP2(fix8_t, fix8_ssub, fix8_t, fix8_t)
+FIXMATH_WRAP2(fix8_t, fix8_smul, fix8_t, fix8_t)
+FIXMATH_WRAP2(fix8_t, fix8_sdiv, fix8_t, fix8_t)
+#endif
+#if defined(FIXMATH_OPTIMIZE_8BIT) && !defined(FIXMATH_NO_OVERFLOW)
+FIXMATH_WRAP2_OVERFLOW(fix8_t, fix8_mul, FIXMATH_OP_FIX8_MUL, fix8_overflow)
+FIXMATH_WRAP2_OVERFLOW(fix8_t, fix8_div, FIXMATH_OP_FIX8_DIV, fix8_overflow)
+#elif defined(FIXMATH_OPTIMIZE_8BIT)
+FIXMATH_WRAP2(fix8_t, fix8_mul, fix8_t, fix8_t)
+FIXMATH_WRAP2(fix8_t, fix8_div, fix8_t, fix8_t)
+#endif
+FIXMATH_WRAP2(fix8_t, fix8_mod, fix8_t, fix8_t)
+#ifndef FIXMATH_NO_64BIT
+FIXMATH_WRAP3(fix8_t, fix8_lerp8, fix8_t, fix8_t, uint8_t)
+FIXMATH_WRAP3(fix8_t, fix8_lerp16, fix8_t, fix8_t, uint16_t)
+FIXMATH_WRAP3(fix8_t, fix8_lerp32, fix8_t, fix8_t, uint32_t)
+#endif
+#endif
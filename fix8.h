@@ -6,12 +6,19 @@ extern "C"
 {
 #endif
 
+#include "libfixmath_conf.h"
+#include <stdint.h>
+
 /* These options may let the optimizer to remove some calls to the functions.
  * Refer to http://gcc.gnu.org/onlinedocs/gcc/Function-Attributes.html
+ * With FIXMATH_STICKY_OVERFLOW the functions write the overflow flag, so
+ * they are not const.
  */
 #ifndef FIXMATH_FUNC_ATTRS
 # ifdef __GNUC__
-#   if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ > 6)
+#   if defined(FIXMATH_STICKY_OVERFLOW)
+#     define FIXMATH_FUNC_ATTRS __attribute__((nothrow))
+#   elif __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ > 6)
 #     define FIXMATH_FUNC_ATTRS __attribute__((leaf, nothrow, const))
 #   else
 #     define FIXMATH_FUNC_ATTRS __attribute__((nothrow, const))
@@ -21,9 +28,6 @@ extern "C"
 # endif
 #endif
 
-#include "libfixmath_conf.h"
-#include <stdint.h>
-
 typedef int16_t fix8_t;
 #if 0
 static const fix8_t FOUR_DIV_PI  = 0x145F3;            /*!< Fix8 value of 4/PI */
@@ -43,6 +47,25 @@ static const fix8_t fix8_e   = 178145;     /*!< fix8_t value of e */
 #endif
 static const fix8_t fix8_one = 0x0100;     /*!< fix8_t value of 1 */
 
+#ifdef FIXMATH_STICKY_OVERFLOW
+/* The sticky overflow flag, shared with fix16_t, see fix16.h. */
+extern FIXMATH_THREAD_LOCAL uint8_t _fixmath_overflow_flag;
+
+/*! Returns nonzero if an operation overflowed since the last
+ * fix8_overflow_clear().
+ */
+static inline int fix8_overflow_occurred(void) { return _fixmath_overflow_flag; }
+
+/*! Clears the overflow flag.
+*/
+static inline void fix8_overflow_clear(void) { _fixmath_overflow_flag = 0; }
+
+#define _FIX8_OVERFLOW(negative) \
+	(_fixmath_overflow_flag = 1, (negative) ? fix8_minimum : fix8_maximum)
+#else
+#define _FIX8_OVERFLOW(negative) fix8_overflow
+#endif
+
 /* Conversion functions between fix8_t and float/integer.
  * These are inlined to allow compiler to optimize away constant numbers
  */
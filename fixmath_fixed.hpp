@@ -0,0 +1,864 @@
+/* Outside of the include guard: fix16.h and fix8.h include fix16.hpp and
+ * fix8.hpp at their end, and this has to follow both of them. */
+#include "fix16.h"
+#include "fix8.h"
+
+#ifndef __libfixmath_fixmath_fixed_hpp__
+#define __libfixmath_fixmath_fixed_hpp__
+
+/* Fixed point number in any Q format: IntBits integer bits, including the
+ * sign, and FracBits fraction bits in a signed int16_t or int32_t Storage,
+ * e.g. FixedPoint<12, 20, int32_t> for Q12.20 or FixedPoint<1, 15, int16_t>
+ * for Q1.15. Fix16 and Fix8 are FixedPoint<16, 16, int32_t> and
+ * FixedPoint<8, 8, int16_t>.
+ *
+ * The Overflow and Rounding policies select the behaviour per type, so one
+ * program can mix them, e.g. wrapping and truncating math in an inner DSP
+ * loop and checked, rounded math around it:
+ * - FixedPointCheck: overflows return fix16_overflow or fix8_overflow, or
+ *   with FIXMATH_STICKY_OVERFLOW saturate and set the flag.
+ * - FixedPointSaturate: overflows saturate, like fix16_sadd etc.
+ * - FixedPointWrap: no checks, like FIXMATH_NO_OVERFLOW. Sums and products
+ *   wrap around, quotients which do not fit are undefined.
+ * - FixedPointNearest: rounding half away from zero.
+ * - FixedPointTruncate: no rounding, like FIXMATH_NO_ROUNDING.
+ * The defaults, FixedPointOverflowDefault and FixedPointRoundingDefault,
+ * follow FIXMATH_NO_OVERFLOW and FIXMATH_NO_ROUNDING.
+ *
+ * FixedPointOps selects the kernels at compile time:
+ * - Q16.16 and Q8.8 with the default policies call the fix16_t and fix8_t
+ *   functions, tuned for each configuration and seen by FIXMATH_PROFILE and
+ *   FIXMATH_TRACE_OVERFLOW. Q8.8 only divides with fix8_div where it exists
+ *   (FIXMATH_OPTIMIZE_8BIT), elsewhere the generic 32-bit division is the
+ *   faster choice anyway. Its product is always the generic 16*16->32 bit
+ *   one, which unlike the 8-bit fix8_mul handles products of two numbers
+ *   with integer parts.
+ * - Other formats and policies use the inline FixedPointKernels, where the
+ *   policies are constants, so each combination compiles to its own kernel
+ *   without the unused checks and rounding. They multiply in the next wider
+ *   integer, with FIXMATH_NO_64BIT in a pair of 32-bit words, and divide
+ *   with one hardware division, with FIXMATH_OPTIMIZE_8BIT or
+ *   FIXMATH_NO_64BIT bit by bit like the 8-bit fix16_div.
+ *
+ * Conversions between formats and policies are shifts, rounded where
+ * fraction bits are lost and checked for overflow where integer bits are
+ * lost, by the policies of the result:
+ *
+ *   FixedPoint<12, 20, int32_t> gain(Fix16(1.5));
+ *
+ * FixedPoint is trivially copyable and standard layout, a Storage value like
+ * the C types, and its construction and conversions are constexpr. The
+ * literals of fix16.hpp and fix8.hpp, e.g. 1.5_fx16 and 0.25_fx8, are
+ * converted at compile time, see FixedPointLiteral.
+ */
+
+/* Integer type of the int_t constructor and conversion, int16_t for Fix16
+ * and int8_t for Fix8. It has to differ from the Storage type.
+ */
+template <bool Wide> struct FixedPointInt       { typedef int16_t type; };
+template <>          struct FixedPointInt<false> { typedef int8_t  type; };
+
+/* product >> FracBits of a product or sum of products in the Wide type,
+ * rounded and checked like fix16_mul_checked.
+ */
+template <int FracBits, bool Nearest, bool Check, typename Wide, typename Storage>
+static inline int fixed_point_wide_result(Wide product, Storage *result, Storage maximum, Storage minimum)
+{
+	// Round half away from zero, which for -1/2 needs one less.
+	if (Nearest)
+		product += ((Wide)1 << (FracBits - 1)) - (product < 0);
+	product >>= FracBits;
+	if (Check && (product > maximum || product < minimum))
+	{
+		*result = (product < 0) ? minimum : maximum;
+		return 1;
+	}
+	*result = (Storage)product;
+	return 0;
+}
+
+/* (a * b) >> FracBits in the Wide type. */
+template <typename Wide, int FracBits, bool Nearest, bool Check, typename Storage>
+static inline int fixed_point_mul_wide(Storage a, Storage b, Storage *result, Storage maximum, Storage minimum)
+{
+	return fixed_point_wide_result<FracBits, Nearest, Check>((Wide)a * b, result, maximum, minimum);
+}
+
+/* The overflow results are constant expressions, e.g. for -Fix16(fix16_minimum)
+ * in a constexpr, except with FIXMATH_STICKY_OVERFLOW, where they set the flag.
+ */
+#ifdef FIXMATH_STICKY_OVERFLOW
+#define FIXMATH_OVERFLOW_CONSTEXPR
+#else
+#define FIXMATH_OVERFLOW_CONSTEXPR constexpr
+#endif
+
+/* Kernels which only depend on the width of the storage. overflow() is the
+ * result of fix16_add etc., saturate() the one of fix16_sadd etc., both
+ * with FIXMATH_STICKY_OVERFLOW setting the flag, limit() is the saturated
+ * value alone.
+ *
+ * acc_t holds exact sums of products, see fixmath_fused.hpp, in 64 bits
+ * like fix16_acc_t, for both storages: acc_product() is a product,
+ * acc_value() a value shifted to the scale of the products, and
+ * acc_result() shifts the sum back like mul_checked.
+ */
+template <typename Storage> struct FixedPointStorage;
+
+template <> struct FixedPointStorage<int32_t>
+{
+	typedef uint32_t unsigned_t;
+#ifndef FIXMATH_NO_64BIT
+	typedef uint64_t unsigned_wide_t;
+#endif
+	static const int32_t maximum = 0x7FFFFFFF;
+	static const int32_t minimum = -0x7FFFFFFF - 1;
+
+	static FIXMATH_OVERFLOW_CONSTEXPR int32_t overflow(bool negative) { return ((void)negative, _FIX16_OVERFLOW(negative)); }
+	static FIXMATH_OVERFLOW_CONSTEXPR int32_t saturate(bool negative) { return _FIX16_SATURATE(negative); }
+	static constexpr int32_t limit(bool negative)    { return negative ? minimum : maximum; }
+
+#ifndef FIXMATH_NO_64BIT
+	typedef int64_t acc_t;
+
+	static acc_t acc_product(int32_t a, int32_t b) { return (int64_t)a * b; }
+	static acc_t acc_add(acc_t a, acc_t b)         { return a + b; }
+	static acc_t acc_sub(acc_t a, acc_t b)         { return a - b; }
+	template <int FracBits> static acc_t acc_value(int32_t a) { return (int64_t)a * ((int64_t)1 << FracBits); }
+
+	template <int FracBits, bool Nearest, bool Check>
+	static int acc_result(acc_t acc, int32_t *result)
+	{
+		return fixed_point_wide_result<FracBits, Nearest, Check>(acc, result, maximum, minimum);
+	}
+
+	template <int FracBits, bool Nearest, bool Check>
+	static int mul_checked(int32_t a, int32_t b, int32_t *result)
+	{
+		return fixed_point_mul_wide<int64_t, FracBits, Nearest, Check>(a, b, result, maximum, minimum);
+	}
+#else
+	// The exact products in two words, as fix16_mac() has them.
+	typedef fix16_acc_t acc_t;
+
+	static acc_t acc_product(int32_t a, int32_t b) { return _fix16_acc_product(a, b); }
+
+	static acc_t acc_add(acc_t a, acc_t b)
+	{
+		uint32_t lo = a.lo + b.lo;
+		a.hi = (int32_t)((uint32_t)a.hi + (uint32_t)b.hi + (lo < a.lo));
+		a.lo = lo;
+		return a;
+	}
+
+	static acc_t acc_sub(acc_t a, acc_t b)
+	{
+		uint32_t lo = a.lo - b.lo;
+		a.hi = (int32_t)((uint32_t)a.hi - (uint32_t)b.hi - (lo > a.lo));
+		a.lo = lo;
+		return a;
+	}
+
+	template <int FracBits> static acc_t acc_value(int32_t a)
+	{
+		acc_t acc = { a >> (32 - FracBits), (uint32_t)a << FracBits };
+		return acc;
+	}
+
+	template <int FracBits, bool Nearest, bool Check>
+	static int acc_result(acc_t acc, int32_t *result)
+	{
+		int32_t hi = acc.hi;
+		uint32_t lo = acc.lo;
+		if (Nearest)
+		{
+			uint32_t half = ((uint32_t)1 << (FracBits - 1)) - (hi < 0);
+			lo += half;
+			if (lo < half)
+				hi = (int32_t)((uint32_t)hi + 1);
+		}
+		lo = (lo >> FracBits) | ((uint32_t)hi << (32 - FracBits));
+		hi >>= FracBits;
+		// The upper word has to be the sign of the lower one.
+		if (Check && hi != ((int32_t)lo >> 31))
+		{
+			*result = limit(hi < 0);
+			return 1;
+		}
+		*result = (int32_t)lo;
+		return 0;
+	}
+
+	template <int FracBits, bool Nearest, bool Check>
+	static int mul_checked(int32_t a, int32_t b, int32_t *result)
+	{
+		return acc_result<FracBits, Nearest, Check>(_fix16_acc_product(a, b), result);
+	}
+#endif
+};
+
+template <> struct FixedPointStorage<int16_t>
+{
+	typedef uint16_t unsigned_t;
+	typedef uint32_t unsigned_wide_t;
+	static const int16_t maximum = 0x7FFF;
+	static const int16_t minimum = -0x7FFF - 1;
+
+	static FIXMATH_OVERFLOW_CONSTEXPR int16_t overflow(bool negative) { return ((void)negative, _FIX8_OVERFLOW(negative)); }
+#ifdef FIXMATH_STICKY_OVERFLOW
+	static int16_t saturate(bool negative) { return _FIX8_OVERFLOW(negative); }
+#else
+	static constexpr int16_t saturate(bool negative) { return limit(negative); }
+#endif
+	static constexpr int16_t limit(bool negative)    { return negative ? minimum : maximum; }
+
+	// Three products of near full scale values exceed 32 bits, so the sums
+	// are kept in the accumulator of the 32-bit storage.
+	typedef FixedPointStorage<int32_t> Wide;
+	typedef Wide::acc_t acc_t;
+
+	static acc_t acc_product(int16_t a, int16_t b) { return Wide::acc_product(a, b); }
+	static acc_t acc_add(acc_t a, acc_t b)         { return Wide::acc_add(a, b); }
+	static acc_t acc_sub(acc_t a, acc_t b)         { return Wide::acc_sub(a, b); }
+	template <int FracBits> static acc_t acc_value(int16_t a) { return Wide::acc_value<FracBits>(a); }
+
+	template <int FracBits, bool Nearest, bool Check>
+	static int acc_result(acc_t acc, int16_t *result)
+	{
+		int32_t wide;
+		int overflow = Wide::acc_result<FracBits, Nearest, Check>(acc, &wide);
+		if (Check && (overflow || wide > maximum || wide < minimum))
+		{
+			*result = limit(wide < 0);
+			return 1;
+		}
+		*result = (int16_t)wide;
+		return 0;
+	}
+
+	template <int FracBits, bool Nearest, bool Check>
+	static int mul_checked(int16_t a, int16_t b, int16_t *result)
+	{
+		return fixed_point_mul_wide<int32_t, FracBits, Nearest, Check>(a, b, result, maximum, minimum);
+	}
+};
+
+/* Overflow policies, see above. check tells whether results are checked,
+ * overflow() returns the result of an overflow or division by zero.
+ */
+struct FixedPointCheck
+{
+	enum { check = 1 };
+	template <typename Storage> static FIXMATH_OVERFLOW_CONSTEXPR Storage overflow(bool negative)
+		{ return FixedPointStorage<Storage>::overflow(negative); }
+};
+
+struct FixedPointSaturate
+{
+	enum { check = 1 };
+	template <typename Storage> static FIXMATH_OVERFLOW_CONSTEXPR Storage overflow(bool negative)
+		{ return FixedPointStorage<Storage>::saturate(negative); }
+};
+
+struct FixedPointWrap
+{
+	enum { check = 0 };
+	// Only division by zero, which returns the overflow value as with
+	// FIXMATH_NO_OVERFLOW.
+	template <typename Storage> static constexpr Storage overflow(bool)
+		{ return FixedPointStorage<Storage>::minimum; }
+};
+
+/* Rounding policies, see above. */
+struct FixedPointNearest  { enum { nearest = 1 }; };
+struct FixedPointTruncate { enum { nearest = 0 }; };
+
+#ifdef FIXMATH_NO_OVERFLOW
+typedef FixedPointWrap FixedPointOverflowDefault;
+#else
+typedef FixedPointCheck FixedPointOverflowDefault;
+#endif
+
+#ifdef FIXMATH_NO_ROUNDING
+typedef FixedPointTruncate FixedPointRoundingDefault;
+#else
+typedef FixedPointNearest FixedPointRoundingDefault;
+#endif
+
+/* Conversion of a value with FracBits2 fraction bits to Storage with
+ * FracBits, by a left shift of FracBits - FracBits2 bits or a rounding
+ * right shift of FracBits2 - FracBits bits.
+ */
+template <int FracBits, int FracBits2, typename Storage, typename Overflow, typename Rounding,
+	bool Right = (FracBits2 > FracBits)>
+struct FixedPointConvert
+{
+	typedef FixedPointStorage<Storage> Base;
+
+	template <typename Storage2> static Storage convert(Storage2 v)
+	{
+		const int shift = FracBits - FracBits2;
+		if (Overflow::check && ((int32_t)v > (Base::maximum >> shift) || (int32_t)v < (Base::minimum >> shift)))
+			return Overflow::template overflow<Storage>(v < 0);
+		return (Storage)((uint32_t)(int32_t)v << shift);
+	}
+};
+
+template <int FracBits, int FracBits2, typename Storage, typename Overflow, typename Rounding>
+struct FixedPointConvert<FracBits, FracBits2, Storage, Overflow, Rounding, true>
+{
+	typedef FixedPointStorage<Storage> Base;
+
+	template <typename Storage2> static Storage convert(Storage2 v)
+	{
+		const int shift = FracBits2 - FracBits;
+		int32_t result;
+		if (Rounding::nearest)
+		{
+			// Round half away from zero: r holds the result and the half
+			// bit, which rounds up unless v is negative and exactly half way.
+			int32_t r = (int32_t)v >> (shift - 1);
+			bool exact_half = !((int32_t)v & (((int32_t)1 << (shift - 1)) - 1));
+			result = (r >> 1) + ((r & 1) && !(v < 0 && exact_half));
+		}
+		else
+		{
+			result = (int32_t)v >> shift;
+		}
+		if (Overflow::check && (result > Base::maximum || result < Base::minimum))
+			return Overflow::template overflow<Storage>(result < 0);
+		return (Storage)result;
+	}
+};
+
+/* Generic kernels of one format and pair of policies. */
+template <int IntBits, int FracBits, typename Storage, typename Overflow, typename Rounding>
+struct FixedPointKernels : FixedPointStorage<Storage>
+{
+	typedef FixedPointStorage<Storage> Base;
+	typedef typename Base::unsigned_t unsigned_t;
+	typedef typename FixedPointInt<(IntBits > 8 && sizeof(Storage) > 2)>::type int_t;
+	typedef FixedPointKernels<IntBits, FracBits, Storage, FixedPointSaturate, Rounding> Saturating;
+
+	static_assert(IntBits >= 1 && FracBits >= 1 && IntBits + FracBits == 8 * sizeof(Storage),
+		"FixedPoint needs a sign bit, a fraction bit, and IntBits + FracBits bits of Storage");
+
+	static FIXMATH_OVERFLOW_CONSTEXPR Storage overflowed(bool negative) { return Overflow::template overflow<Storage>(negative); }
+
+	/* The conversions are constexpr, single expressions as C++11 needs. */
+	static constexpr Storage from_int(int_t a) { return (Storage)((unsigned_t)a << FracBits); }
+	static constexpr float   to_float(Storage a) { return (float)a / ((unsigned_t)1 << FracBits); }
+	static constexpr double  to_dbl(Storage a)   { return (double)a / ((unsigned_t)1 << FracBits); }
+
+	// Round half away from zero, as fix16_to_int does.
+	static constexpr int_t to_int(Storage a)
+	{
+		return !Rounding::nearest ? (int_t)(a >> FracBits)
+			: (a >= 0) ? (int_t)(((unsigned_t)a + ((unsigned_t)1 << (FracBits - 1))) >> FracBits)
+			: -(int_t)(((unsigned_t)(0 - (unsigned_t)a) + ((unsigned_t)1 << (FracBits - 1))) >> FracBits);
+	}
+
+	static constexpr Storage from_float(float a)
+	{
+		return (Storage)(a * ((unsigned_t)1 << FracBits)
+			+ (Rounding::nearest ? ((a >= 0) ? 0.5f : -0.5f) : 0.0f));
+	}
+
+	static constexpr Storage from_dbl(double a)
+	{
+		return (Storage)(a * ((unsigned_t)1 << FracBits)
+			+ (Rounding::nearest ? ((a >= 0) ? 0.5f : -0.5f) : 0.0f));
+	}
+
+	static Storage add(Storage a, Storage b)
+	{
+		Storage sum = (Storage)((unsigned_t)a + (unsigned_t)b);
+		// Overflow can only happen if sign of a == sign of b, and then
+		// it causes sign of sum != sign of a.
+		if (Overflow::check && (~(a ^ b) & (a ^ sum)) < 0)
+			return overflowed(a < 0);
+		return sum;
+	}
+
+	static Storage sub(Storage a, Storage b)
+	{
+		Storage diff = (Storage)((unsigned_t)a - (unsigned_t)b);
+		// Overflow can only happen if sign of a != sign of b, and then
+		// it causes sign of diff != sign of a.
+		if (Overflow::check && ((a ^ b) & (a ^ diff)) < 0)
+			return overflowed(a < 0);
+		return diff;
+	}
+
+	/* Like fix16_mul_checked: stores the result, or on overflow the
+	 * saturated result and returns nonzero. Never reports overflow with
+	 * FixedPointWrap. */
+	static int mul_checked(Storage a, Storage b, Storage *result)
+	{
+		return Base::template mul_checked<FracBits, Rounding::nearest, Overflow::check>(a, b, result);
+	}
+
+	/* Like fix16_div_checked, but always rounded exactly, as fix16_div is
+	 * with FIXMATH_DIV64 or FIXMATH_OPTIMIZE_8BIT. With FixedPointWrap
+	 * only reports division by zero. */
+	static int div_checked(Storage a, Storage b, Storage *result)
+	{
+		if (b == 0)
+		{
+			*result = Base::limit(a < 0);
+			return 1;
+		}
+
+		bool negative = (a < 0) != (b < 0);
+#if defined(FIXMATH_OPTIMIZE_8BIT) || defined(FIXMATH_NO_64BIT)
+		// The restoring division of the 8-bit fix16_div, starting at the
+		// bit of 1 in the format.
+		uint32_t remainder = (a >= 0) ? (uint32_t)a : (0 - (uint32_t)a);
+		uint32_t divider = (b >= 0) ? (uint32_t)b : (0 - (uint32_t)b);
+		uint32_t quotient = 0;
+		uint32_t bit = (uint32_t)1 << FracBits;
+
+		while (divider < remainder)
+		{
+			divider <<= 1;
+			bit <<= 1;
+		}
+
+		if (Overflow::check && !bit)
+		{
+			*result = Base::limit(negative);
+			return 1;
+		}
+
+		if (divider & 0x80000000)
+		{
+			if (remainder >= divider)
+			{
+				quotient |= bit;
+				remainder -= divider;
+			}
+			divider >>= 1;
+			bit >>= 1;
+		}
+
+		while (bit && remainder)
+		{
+			if (remainder >= divider)
+			{
+				quotient |= bit;
+				remainder -= divider;
+			}
+			remainder <<= 1;
+			bit >>= 1;
+		}
+
+		if (Rounding::nearest && remainder >= divider)
+			quotient++;
+#else
+		// (|a| << (FracBits + 1)) / |b| with one division, rounded like
+		// the 64-bit fix16_div.
+		typedef typename Base::unsigned_wide_t unsigned_wide_t;
+		unsigned_wide_t remainder = (a >= 0) ? (unsigned_wide_t)a : (0 - (unsigned_wide_t)a);
+		unsigned_wide_t divider = (b >= 0) ? (unsigned_wide_t)b : (0 - (unsigned_wide_t)b);
+		unsigned_wide_t quotient = (remainder << (FracBits + 1)) / divider;
+		if (Rounding::nearest)
+			quotient++;
+		quotient >>= 1;
+#endif
+
+		// Only a negative result, the minimum, can have the highest bit set.
+		if (Overflow::check && quotient > (uint32_t)Base::maximum + negative)
+		{
+			*result = Base::limit(negative);
+			return 1;
+		}
+		*result = (Storage)(negative ? (0 - (unsigned_t)quotient) : (unsigned_t)quotient);
+		return 0;
+	}
+
+	static Storage mul(Storage a, Storage b)
+	{
+		Storage result;
+		if (mul_checked(a, b, &result))
+			return overflowed(result < 0);
+		return result;
+	}
+
+	/* A value at the scale of the products in the accumulator. */
+	static typename Base::acc_t acc_value(Storage a) { return Base::template acc_value<FracBits>(a); }
+
+	/* A sum of products, rounded and checked once like mul. */
+	static Storage acc_result(typename Base::acc_t acc)
+	{
+		Storage result;
+		if (Base::template acc_result<FracBits, Rounding::nearest, Overflow::check>(acc, &result))
+			return overflowed(result < 0);
+		return result;
+	}
+
+	static Storage div(Storage a, Storage b)
+	{
+		Storage result;
+		if (div_checked(a, b, &result))
+			return overflowed(result < 0);
+		return result;
+	}
+
+	static Storage sadd(Storage a, Storage b) { return Saturating::add(a, b); }
+	static Storage ssub(Storage a, Storage b) { return Saturating::sub(a, b); }
+	static Storage smul(Storage a, Storage b) { return Saturating::mul(a, b); }
+	static Storage sdiv(Storage a, Storage b) { return Saturating::div(a, b); }
+
+	/* Division by a positive integer constant, rounded like div. */
+	template <uint32_t N> static Storage div_by(Storage a)
+	{
+		unsigned_t remainder = (a >= 0) ? (unsigned_t)a : (unsigned_t)(0 - (unsigned_t)a);
+		unsigned_t quotient = remainder / N;
+		if (Rounding::nearest)
+		{
+			remainder -= quotient * N;
+			quotient += (remainder >= N - remainder);
+		}
+		return (Storage)((a >= 0) ? quotient : (unsigned_t)(0 - quotient));
+	}
+};
+
+template <int IntBits, int FracBits, typename Storage, typename Overflow, typename Rounding>
+struct FixedPointOps : FixedPointKernels<IntBits, FracBits, Storage, Overflow, Rounding> {};
+
+/* The fix16_t functions which do not depend on the policies. */
+struct FixedPointFix16Math
+{
+	static int32_t sin(int32_t a)  { return fix16_sin(a);  }
+	static int32_t cos(int32_t a)  { return fix16_cos(a);  }
+	static int32_t tan(int32_t a)  { return fix16_tan(a);  }
+	static int32_t asin(int32_t a) { return fix16_asin(a); }
+	static int32_t acos(int32_t a) { return fix16_acos(a); }
+	static int32_t atan(int32_t a) { return fix16_atan(a); }
+	static int32_t atan2(int32_t a, int32_t b) { return fix16_atan2(a, b); }
+	static int32_t sqrt(int32_t a) { return fix16_sqrt(a); }
+};
+
+template <typename Overflow, typename Rounding>
+struct FixedPointOps<16, 16, int32_t, Overflow, Rounding>
+	: FixedPointKernels<16, 16, int32_t, Overflow, Rounding>, FixedPointFix16Math {};
+
+template <>
+struct FixedPointOps<16, 16, int32_t, FixedPointOverflowDefault, FixedPointRoundingDefault>
+	: FixedPointKernels<16, 16, int32_t, FixedPointOverflowDefault, FixedPointRoundingDefault>, FixedPointFix16Math
+{
+	static int32_t add(int32_t a, int32_t b) { return fix16_add(a, b); }
+	static int32_t sub(int32_t a, int32_t b) { return fix16_sub(a, b); }
+	static int32_t mul(int32_t a, int32_t b) { return fix16_mul(a, b); }
+	static int32_t div(int32_t a, int32_t b) { return fix16_div(a, b); }
+#ifndef FIXMATH_NO_OVERFLOW
+	static int32_t sadd(int32_t a, int32_t b) { return fix16_sadd(a, b); }
+	static int32_t ssub(int32_t a, int32_t b) { return fix16_ssub(a, b); }
+	static int32_t smul(int32_t a, int32_t b) { return fix16_smul(a, b); }
+	static int32_t sdiv(int32_t a, int32_t b) { return fix16_sdiv(a, b); }
+#endif
+	template <uint32_t N> static int32_t div_by(int32_t a) { return FIX16_DIV_CONST(a, N); }
+};
+
+template <>
+struct FixedPointOps<8, 8, int16_t, FixedPointOverflowDefault, FixedPointRoundingDefault>
+	: FixedPointKernels<8, 8, int16_t, FixedPointOverflowDefault, FixedPointRoundingDefault>
+{
+	static int16_t add(int16_t a, int16_t b) { return fix8_add(a, b); }
+	static int16_t sub(int16_t a, int16_t b) { return fix8_sub(a, b); }
+#ifndef FIXMATH_NO_OVERFLOW
+	static int16_t sadd(int16_t a, int16_t b) { return fix8_sadd(a, b); }
+	static int16_t ssub(int16_t a, int16_t b) { return fix8_ssub(a, b); }
+#endif
+#ifdef FIXMATH_OPTIMIZE_8BIT
+	static int16_t div(int16_t a, int16_t b) { return fix8_div(a, b); }
+#ifndef FIXMATH_NO_OVERFLOW
+	static int16_t sdiv(int16_t a, int16_t b) { return fix8_sdiv(a, b); }
+#endif
+#endif
+};
+
+template <int IntBits, int FracBits, typename Storage,
+	typename Overflow = FixedPointOverflowDefault, typename Rounding = FixedPointRoundingDefault>
+class FixedPoint {
+	public:
+		typedef FixedPointOps<IntBits, FracBits, Storage, Overflow, Rounding> Ops;
+		typedef typename Ops::int_t int_t;
+
+		Storage value;
+
+		// The copy constructor and assignment are the implicit ones, so
+		// that FixedPoint is trivially copyable like its Storage.
+		constexpr FixedPoint() : value(0) {}
+		constexpr FixedPoint(const Storage inValue) : value(inValue)                 {}
+		constexpr FixedPoint(const float inValue)   : value(Ops::from_float(inValue)) {}
+		constexpr FixedPoint(const double inValue)  : value(Ops::from_dbl(inValue))   {}
+		constexpr FixedPoint(const int_t inValue)   : value(Ops::from_int(inValue))   {}
+
+		// Conversion from another format or policy, see FixedPointConvert.
+		template <int IntBits2, int FracBits2, typename Storage2, typename Overflow2, typename Rounding2>
+		explicit FixedPoint(const FixedPoint<IntBits2, FracBits2, Storage2, Overflow2, Rounding2> &inValue)
+			{ value = FixedPointConvert<FracBits, FracBits2, Storage, Overflow, Rounding>::convert(inValue.value); }
+
+		constexpr operator Storage() const { return value;                 }
+		constexpr operator double()  const { return Ops::to_dbl(value);   }
+		constexpr operator float()   const { return Ops::to_float(value); }
+		constexpr operator int_t()   const { return Ops::to_int(value);   }
+		constexpr operator bool()    const { return bool(value);          }
+
+		FixedPoint & operator=(const Storage rhs)     { value = rhs;                   return *this; }
+		FixedPoint & operator=(const double rhs)      { value = Ops::from_dbl(rhs);   return *this; }
+		FixedPoint & operator=(const float rhs)       { value = Ops::from_float(rhs); return *this; }
+		FixedPoint & operator=(const int_t rhs)       { value = Ops::from_int(rhs);   return *this; }
+
+		FixedPoint & operator+=(const FixedPoint &rhs) { value = Ops::add(value, rhs.value);             return *this; }
+		FixedPoint & operator+=(const Storage rhs)     { value = Ops::add(value, rhs);                   return *this; }
+		FixedPoint & operator+=(const double rhs)      { value = Ops::add(value, Ops::from_dbl(rhs));   return *this; }
+		FixedPoint & operator+=(const float rhs)       { value = Ops::add(value, Ops::from_float(rhs)); return *this; }
+		FixedPoint & operator+=(const int_t rhs)       { value = Ops::add(value, Ops::from_int(rhs));   return *this; }
+
+		FixedPoint & operator-=(const FixedPoint &rhs) { value = Ops::sub(value, rhs.value);             return *this; }
+		FixedPoint & operator-=(const Storage rhs)     { value = Ops::sub(value, rhs);                   return *this; }
+		FixedPoint & operator-=(const double rhs)      { value = Ops::sub(value, Ops::from_dbl(rhs));   return *this; }
+		FixedPoint & operator-=(const float rhs)       { value = Ops::sub(value, Ops::from_float(rhs)); return *this; }
+		FixedPoint & operator-=(const int_t rhs)       { value = Ops::sub(value, Ops::from_int(rhs));   return *this; }
+
+		FixedPoint & operator*=(const FixedPoint &rhs) { value = Ops::mul(value, rhs.value);             return *this; }
+		FixedPoint & operator*=(const Storage rhs)     { value = Ops::mul(value, rhs);                   return *this; }
+		FixedPoint & operator*=(const double rhs)      { value = Ops::mul(value, Ops::from_dbl(rhs));   return *this; }
+		FixedPoint & operator*=(const float rhs)       { value = Ops::mul(value, Ops::from_float(rhs)); return *this; }
+		FixedPoint & operator*=(const int_t rhs)       { value = Ops::mul(value, Ops::from_int(rhs));   return *this; }
+
+		FixedPoint & operator/=(const FixedPoint &rhs) { value = Ops::div(value, rhs.value);             return *this; }
+		FixedPoint & operator/=(const Storage rhs)     { value = Ops::div(value, rhs);                   return *this; }
+		FixedPoint & operator/=(const double rhs)      { value = Ops::div(value, Ops::from_dbl(rhs));   return *this; }
+		FixedPoint & operator/=(const float rhs)       { value = Ops::div(value, Ops::from_float(rhs)); return *this; }
+		FixedPoint & operator/=(const int_t rhs)       { value = Ops::div(value, Ops::from_int(rhs));   return *this; }
+
+		const FixedPoint operator+(const FixedPoint &other) const { FixedPoint ret = *this; ret += other; return ret; }
+		const FixedPoint operator+(const Storage other) const     { FixedPoint ret = *this; ret += other; return ret; }
+		const FixedPoint operator+(const double other) const      { FixedPoint ret = *this; ret += other; return ret; }
+		const FixedPoint operator+(const float other) const       { FixedPoint ret = *this; ret += other; return ret; }
+		const FixedPoint operator+(const int_t other) const       { FixedPoint ret = *this; ret += other; return ret; }
+
+		// Saturating whatever the Overflow policy, like fix16_sadd etc.
+		const FixedPoint sadd(const FixedPoint &other) const { FixedPoint ret = Ops::sadd(value, other.value);             return ret; }
+		const FixedPoint sadd(const Storage other) const     { FixedPoint ret = Ops::sadd(value, other);                   return ret; }
+		const FixedPoint sadd(const double other) const      { FixedPoint ret = Ops::sadd(value, Ops::from_dbl(other));   return ret; }
+		const FixedPoint sadd(const float other) const       { FixedPoint ret = Ops::sadd(value, Ops::from_float(other)); return ret; }
+		const FixedPoint sadd(const int_t other) const       { FixedPoint ret = Ops::sadd(value, Ops::from_int(other));   return ret; }
+
+		// Negation, which only overflows for the minimum. constexpr for
+		// negative literals, e.g. -1.5_fx16, and for the minimum except with
+		// FIXMATH_STICKY_OVERFLOW.
+		constexpr FixedPoint operator-() const
+		{
+			return FixedPoint((value == Ops::minimum) ? Ops::overflowed(false)
+				: (Storage)(0 - (typename Ops::unsigned_t)value));
+		}
+
+		const FixedPoint operator-(const FixedPoint &other) const { FixedPoint ret = *this; ret -= other; return ret; }
+		const FixedPoint operator-(const Storage other) const     { FixedPoint ret = *this; ret -= other; return ret; }
+		const FixedPoint operator-(const double other) const      { FixedPoint ret = *this; ret -= other; return ret; }
+		const FixedPoint operator-(const float other) const       { FixedPoint ret = *this; ret -= other; return ret; }
+		const FixedPoint operator-(const int_t other) const       { FixedPoint ret = *this; ret -= other; return ret; }
+
+		const FixedPoint ssub(const FixedPoint &other) const { FixedPoint ret = Ops::ssub(value, other.value);             return ret; }
+		const FixedPoint ssub(const Storage other) const     { FixedPoint ret = Ops::ssub(value, other);                   return ret; }
+		const FixedPoint ssub(const double other) const      { FixedPoint ret = Ops::ssub(value, Ops::from_dbl(other));   return ret; }
+		const FixedPoint ssub(const float other) const       { FixedPoint ret = Ops::ssub(value, Ops::from_float(other)); return ret; }
+		const FixedPoint ssub(const int_t other) const       { FixedPoint ret = Ops::ssub(value, Ops::from_int(other));   return ret; }
+
+		const FixedPoint operator*(const FixedPoint &other) const { FixedPoint ret = *this; ret *= other; return ret; }
+		const FixedPoint operator*(const Storage other) const     { FixedPoint ret = *this; ret *= other; return ret; }
+		const FixedPoint operator*(const double other) const      { FixedPoint ret = *this; ret *= other; return ret; }
+		const FixedPoint operator*(const float other) const       { FixedPoint ret = *this; ret *= other; return ret; }
+		const FixedPoint operator*(const int_t other) const       { FixedPoint ret = *this; ret *= other; return ret; }
+
+		const FixedPoint smul(const FixedPoint &other) const { FixedPoint ret = Ops::smul(value, other.value);             return ret; }
+		const FixedPoint smul(const Storage other) const     { FixedPoint ret = Ops::smul(value, other);                   return ret; }
+		const FixedPoint smul(const double other) const      { FixedPoint ret = Ops::smul(value, Ops::from_dbl(other));   return ret; }
+		const FixedPoint smul(const float other) const       { FixedPoint ret = Ops::smul(value, Ops::from_float(other)); return ret; }
+		const FixedPoint smul(const int_t other) const       { FixedPoint ret = Ops::smul(value, Ops::from_int(other));   return ret; }
+
+		const FixedPoint operator/(const FixedPoint &other) const { FixedPoint ret = *this; ret /= other; return ret; }
+		const FixedPoint operator/(const Storage other) const     { FixedPoint ret = *this; ret /= other; return ret; }
+		const FixedPoint operator/(const double other) const      { FixedPoint ret = *this; ret /= other; return ret; }
+		const FixedPoint operator/(const float other) const       { FixedPoint ret = *this; ret /= other; return ret; }
+		const FixedPoint operator/(const int_t other) const       { FixedPoint ret = *this; ret /= other; return ret; }
+
+		const FixedPoint sdiv(const FixedPoint &other) const { FixedPoint ret = Ops::sdiv(value, other.value);             return ret; }
+		const FixedPoint sdiv(const Storage other) const     { FixedPoint ret = Ops::sdiv(value, other);                   return ret; }
+		const FixedPoint sdiv(const double other) const      { FixedPoint ret = Ops::sdiv(value, Ops::from_dbl(other));   return ret; }
+		const FixedPoint sdiv(const float other) const       { FixedPoint ret = Ops::sdiv(value, Ops::from_float(other)); return ret; }
+		const FixedPoint sdiv(const int_t other) const       { FixedPoint ret = Ops::sdiv(value, Ops::from_int(other));   return ret; }
+
+		// Division by an integer constant, without a division, see FIX16_DIV_CONST.
+		template <uint32_t N> const FixedPoint div_by() const { FixedPoint ret = Ops::template div_by<N>(value); return ret; }
+
+		const int operator==(const FixedPoint &other) const { return (value == other.value);             }
+		const int operator==(const Storage other) const     { return (value == other);                   }
+		const int operator==(const double other) const      { return (value == Ops::from_dbl(other));   }
+		const int operator==(const float other) const       { return (value == Ops::from_float(other)); }
+		const int operator==(const int_t other) const       { return (value == Ops::from_int(other));   }
+
+		const int operator!=(const FixedPoint &other) const { return (value != other.value);             }
+		const int operator!=(const Storage other) const     { return (value != other);                   }
+		const int operator!=(const double other) const      { return (value != Ops::from_dbl(other));   }
+		const int operator!=(const float other) const       { return (value != Ops::from_float(other)); }
+		const int operator!=(const int_t other) const       { return (value != Ops::from_int(other));   }
+
+		const int operator<=(const FixedPoint &other) const { return (value <= other.value);             }
+		const int operator<=(const Storage other) const     { return (value <= other);                   }
+		const int operator<=(const double other) const      { return (value <= Ops::from_dbl(other));   }
+		const int operator<=(const float other) const       { return (value <= Ops::from_float(other)); }
+		const int operator<=(const int_t other) const       { return (value <= Ops::from_int(other));   }
+
+		const int operator>=(const FixedPoint &other) const { return (value >= other.value);             }
+		const int operator>=(const Storage other) const     { return (value >= other);                   }
+		const int operator>=(const double other) const      { return (value >= Ops::from_dbl(other));   }
+		const int operator>=(const float other) const       { return (value >= Ops::from_float(other)); }
+		const int operator>=(const int_t other) const       { return (value >= Ops::from_int(other));   }
+
+		const int operator< (const FixedPoint &other) const { return (value <  other.value);             }
+		const int operator< (const Storage other) const     { return (value <  other);                   }
+		const int operator< (const double other) const      { return (value <  Ops::from_dbl(other));   }
+		const int operator< (const float other) const       { return (value <  Ops::from_float(other)); }
+		const int operator< (const int_t other) const       { return (value <  Ops::from_int(other));   }
+
+		const int operator> (const FixedPoint &other) const { return (value >  other.value);             }
+		const int operator> (const Storage other) const     { return (value >  other);                   }
+		const int operator> (const double other) const      { return (value >  Ops::from_dbl(other));   }
+		const int operator> (const float other) const       { return (value >  Ops::from_float(other)); }
+		const int operator> (const int_t other) const       { return (value >  Ops::from_int(other));   }
+
+		// Only for the formats whose FixedPointOps have them, i.e. Fix16.
+		FixedPoint  sin() const { return FixedPoint(Ops::sin(value));  }
+		FixedPoint  cos() const { return FixedPoint(Ops::cos(value));  }
+		FixedPoint  tan() const { return FixedPoint(Ops::tan(value));  }
+		FixedPoint asin() const { return FixedPoint(Ops::asin(value)); }
+		FixedPoint acos() const { return FixedPoint(Ops::acos(value)); }
+		FixedPoint atan() const { return FixedPoint(Ops::atan(value)); }
+		FixedPoint atan2(const FixedPoint &inY) const { return FixedPoint(Ops::atan2(value, inY.value)); }
+		FixedPoint sqrt() const { return FixedPoint(Ops::sqrt(value)); }
+};
+
+/* Decimal literals, parsed at compile time by the literal operators of
+ * fix16.hpp and fix8.hpp. The raw literal operator templates get the
+ * characters of the literal, e.g. '1', '.', '5', so the result is exact and
+ * does not depend on the float or double of the target, and no floating
+ * point code is generated even on AVR.
+ *
+ * FixedPointDecimal is the value read so far, mantissa * 10^(exponent -
+ * scale). Digits beyond 18 significant ones are dropped.
+ */
+struct FixedPointDecimal
+{
+	uint64_t mantissa;
+	int      scale;         // Digits after the point, less integer digits dropped
+	int      exponent;      // After the 'e'
+	char     part;          // 'i'nteger, 'f'raction, exponent 's'ign or 'e'xponent
+	bool     negative;      // Exponent
+	int      digits;        // Of the integer part
+	bool     leading_zero;  // Of the integer part
+	bool     error;
+};
+
+static constexpr FixedPointDecimal fixed_point_decimal_part(FixedPointDecimal d, char part, bool negative, bool error)
+{
+	return FixedPointDecimal{d.mantissa, d.scale, d.exponent, part, negative, d.digits, d.leading_zero, error};
+}
+
+static constexpr FixedPointDecimal fixed_point_decimal_digit(FixedPointDecimal d, int digit)
+{
+	return (d.part == 's' || d.part == 'e')
+		? FixedPointDecimal{d.mantissa, d.scale, (d.exponent < 1000) ? d.exponent * 10 + digit : d.exponent,
+			'e', d.negative, d.digits, d.leading_zero, d.error || d.exponent >= 1000}
+		: (d.mantissa < 100000000000000000ULL)
+		? FixedPointDecimal{d.mantissa * 10 + digit, d.scale + (d.part == 'f'), d.exponent, d.part, d.negative,
+			d.digits + (d.part == 'i'), d.leading_zero || (d.part == 'i' && d.digits == 0 && digit == 0), d.error}
+		: FixedPointDecimal{d.mantissa, d.scale - (d.part == 'i'), d.exponent, d.part, d.negative,
+			d.digits + (d.part == 'i'), d.leading_zero, d.error};
+}
+
+static constexpr FixedPointDecimal fixed_point_decimal_char(FixedPointDecimal d, char c)
+{
+	return (c >= '0' && c <= '9') ? fixed_point_decimal_digit(d, c - '0')
+		: (c == '.' && d.part == 'i') ? fixed_point_decimal_part(d, 'f', false, d.error)
+		: ((c == 'e' || c == 'E') && (d.part == 'i' || d.part == 'f')) ? fixed_point_decimal_part(d, 's', false, d.error)
+		: ((c == '-' || c == '+') && d.part == 's') ? fixed_point_decimal_part(d, 'e', c == '-', d.error)
+		: (c == '\'') ? d  // Digit separator of C++14
+		: fixed_point_decimal_part(d, d.part, d.negative, true);
+}
+
+template <char C>
+static constexpr FixedPointDecimal fixed_point_decimal_parse(FixedPointDecimal d)
+{
+	return fixed_point_decimal_char(d, C);
+}
+
+template <char C, char C2, char... Chars>
+static constexpr FixedPointDecimal fixed_point_decimal_parse(FixedPointDecimal d)
+{
+	return fixed_point_decimal_parse<C2, Chars...>(fixed_point_decimal_char(d, C));
+}
+
+/* Hexadecimal and binary integers are rejected, as are octal ones whose
+ * decimal reading differs, i.e. above 07, and a missing exponent. */
+static constexpr bool fixed_point_decimal_valid(FixedPointDecimal d)
+{
+	return !d.error && d.part != 's' && !(d.part == 'i' && d.leading_zero && d.digits > 1 && d.mantissa > 7);
+}
+
+static constexpr uint64_t fixed_point_pow10(int n)
+{
+	return n ? 10 * fixed_point_pow10(n - 1) : 1;
+}
+
+/* integer + remainder / divisor with FracBits more bits, by long division. */
+static constexpr uint64_t fixed_point_decimal_bits(uint64_t integer, uint64_t remainder, uint64_t divisor,
+	int bits, bool nearest)
+{
+	return bits == 0 ? integer + (nearest && 2 * remainder >= divisor)
+		: fixed_point_decimal_bits(2 * integer + (2 * remainder >= divisor),
+			(2 * remainder >= divisor) ? 2 * remainder - divisor : 2 * remainder, divisor, bits - 1, nearest);
+}
+
+/* mantissa * 10^e with bits fraction bits, rounded half up if nearest, or
+ * ~0 if the integer part does not fit in 32 bits. */
+static constexpr uint64_t fixed_point_decimal_fixed(uint64_t mantissa, int e, int bits, bool nearest)
+{
+	return (mantissa == 0) ? 0
+		: (e > 9) ? ~(uint64_t)0
+		: (e >= 0) ? ((mantissa > 0xFFFFFFFFULL / fixed_point_pow10(e)) ? ~(uint64_t)0
+			: (mantissa * fixed_point_pow10(e)) << bits)
+		: (e < -18) ? fixed_point_decimal_fixed(mantissa / 10, e + 1, bits, nearest)
+		: (mantissa / fixed_point_pow10(-e) > 0xFFFFFFFFULL) ? ~(uint64_t)0
+		: fixed_point_decimal_bits(mantissa / fixed_point_pow10(-e), mantissa % fixed_point_pow10(-e),
+			fixed_point_pow10(-e), bits, nearest);
+}
+
+static constexpr uint64_t fixed_point_decimal_value(FixedPointDecimal d, int bits, bool nearest)
+{
+	return fixed_point_decimal_fixed(d.mantissa, (d.negative ? -d.exponent : d.exponent) - d.scale, bits, nearest);
+}
+
+/* The Storage value of the literal Chars with FracBits fraction bits,
+ * rounded by the Rounding policy. Literals are never negative, -1.5_fx16
+ * is the negation of 1.5_fx16. */
+template <int FracBits, typename Storage, typename Rounding, char... Chars>
+struct FixedPointLiteral
+{
+	static constexpr bool valid = fixed_point_decimal_valid(
+		fixed_point_decimal_parse<Chars...>(FixedPointDecimal{0, 0, 0, 'i', false, 0, false, false}));
+	static constexpr uint64_t raw = fixed_point_decimal_value(
+		fixed_point_decimal_parse<Chars...>(FixedPointDecimal{0, 0, 0, 'i', false, 0, false, false}),
+		FracBits, Rounding::nearest);
+
+	static_assert(valid, "fixed point literals have to be decimal numbers");
+	static_assert(!valid || raw <= (uint64_t)FixedPointStorage<Storage>::maximum, "fixed point literal out of range");
+
+	static constexpr Storage value = (Storage)raw;
+};
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef __libfixmath_fixmath_fused_hpp__
+#define __libfixmath_fixmath_fused_hpp__
+
+#include "fixmath_fixed.hpp"
+
+/* Fused sums of products of FixedPoint numbers. An expression starting
+ * with fused() is not evaluated operator by operator, but kept as a tree of
+ * its operands and summed exactly in the acc_t of the format, an int64_t or
+ * fix16_acc_t, which is then rounded and checked once, by the policies of
+ * the format:
+ *
+ *   Fix16 y = fused(a) * b + fused(c) * d - e;
+ *
+ * costs about one fix16_mul instead of two fix16_mul, a fix16_add and a
+ * fix16_sub, and has one rounding instead of two. Each product has to start
+ * with fused(), c * d alone would be an ordinary rounded Fix16 product.
+ * Sums, differences, negations and products with plain values, e.g.
+ * fused(a) * 0.5, are fused. A factor which is itself fused is evaluated
+ * first: fused(a) * b * c rounds a * b, and fused(a + b) * c the sum.
+ *
+ * The accumulator has 64 bits, so the partial sums of Fix16 may go up to
+ * about twice the largest product, as with fix16_acc_t, and those of the
+ * 16-bit formats to 2^32 products. Only the final result overflows.
+ */
+
+/* Base of the nodes of an expression over Fixed. Each node has an acc()
+ * with its exact value in the accumulator, and converts to Fixed.
+ */
+template <typename Fixed, typename Expr>
+struct FixedPointExpr
+{
+	typedef typename Fixed::Ops Ops;
+	typedef typename Ops::acc_t acc_t;
+
+	const Expr &expr() const { return *static_cast<const Expr *>(this); }
+
+	Fixed value() const { return Fixed(Ops::acc_result(expr().acc())); }
+	operator Fixed() const { return value(); }
+};
+
+/* A value, e.g. fused(a). */
+template <typename Fixed>
+struct FixedPointTerm : FixedPointExpr<Fixed, FixedPointTerm<Fixed> >
+{
+	typedef typename Fixed::Ops Ops;
+
+	Fixed term;
+
+	explicit FixedPointTerm(const Fixed &inValue) : term(inValue) {}
+
+	typename Ops::acc_t acc() const { return Ops::acc_value(term.value); }
+	Fixed value() const    { return term; }
+	operator Fixed() const { return term; }
+};
+
+template <typename Fixed, typename Left, typename Right>
+struct FixedPointProduct : FixedPointExpr<Fixed, FixedPointProduct<Fixed, Left, Right> >
+{
+	typedef typename Fixed::Ops Ops;
+
+	Left left;
+	Right right;
+
+	FixedPointProduct(const Left &inLeft, const Right &inRight) : left(inLeft), right(inRight) {}
+
+	typename Ops::acc_t acc() const { return Ops::acc_product(left.value().value, right.value().value); }
+};
+
+template <typename Fixed, typename Left, typename Right, bool Subtract>
+struct FixedPointSum : FixedPointExpr<Fixed, FixedPointSum<Fixed, Left, Right, Subtract> >
+{
+	typedef typename Fixed::Ops Ops;
+
+	Left left;
+	Right right;
+
+	FixedPointSum(const Left &inLeft, const Right &inRight) : left(inLeft), right(inRight) {}
+
+	typename Ops::acc_t acc() const
+	{
+		return Subtract ? Ops::acc_sub(left.acc(), right.acc()) : Ops::acc_add(left.acc(), right.acc());
+	}
+};
+
+template <typename Fixed, typename Left, typename Right>
+using FixedPointAdd = FixedPointSum<Fixed, Left, Right, false>;
+template <typename Fixed, typename Left, typename Right>
+using FixedPointSubtract = FixedPointSum<Fixed, Left, Right, true>;
+
+template <typename Fixed, typename Operand>
+struct FixedPointNegate : FixedPointExpr<Fixed, FixedPointNegate<Fixed, Operand> >
+{
+	typedef typename Fixed::Ops Ops;
+
+	Operand operand;
+
+	explicit FixedPointNegate(const Operand &inOperand) : operand(inOperand) {}
+
+	typename Ops::acc_t acc() const { return Ops::acc_sub(Ops::acc_value(0), operand.acc()); }
+};
+
+/* Starts a fused expression. */
+template <int IntBits, int FracBits, typename Storage, typename Overflow, typename Rounding>
+FixedPointTerm<FixedPoint<IntBits, FracBits, Storage, Overflow, Rounding> >
+	fused(const FixedPoint<IntBits, FracBits, Storage, Overflow, Rounding> &inValue)
+{
+	return FixedPointTerm<FixedPoint<IntBits, FracBits, Storage, Overflow, Rounding> >(inValue);
+}
+
+/* Fixed only deduced from the node, so that the other operand converts to
+ * it, e.g. from a double. */
+template <typename Fixed> struct FixedPointSame { typedef Fixed type; };
+
+#define FIXMATH_FUSED_OPERATOR(op, Node) \
+	template <typename Fixed, typename Left, typename Right> \
+	Node<Fixed, Left, Right> \
+		operator op(const FixedPointExpr<Fixed, Left> &left, const FixedPointExpr<Fixed, Right> &right) \
+		{ return Node<Fixed, Left, Right>(left.expr(), right.expr()); } \
+	template <typename Fixed, typename Left> \
+	Node<Fixed, Left, FixedPointTerm<Fixed> > \
+		operator op(const FixedPointExpr<Fixed, Left> &left, const typename FixedPointSame<Fixed>::type &right) \
+		{ return Node<Fixed, Left, FixedPointTerm<Fixed> >(left.expr(), FixedPointTerm<Fixed>(right)); } \
+	template <typename Fixed, typename Right> \
+	Node<Fixed, FixedPointTerm<Fixed>, Right> \
+		operator op(const typename FixedPointSame<Fixed>::type &left, const FixedPointExpr<Fixed, Right> &right) \
+		{ return Node<Fixed, FixedPointTerm<Fixed>, Right>(FixedPointTerm<Fixed>(left), right.expr()); }
+
+FIXMATH_FUSED_OPERATOR(*, FixedPointProduct)
+FIXMATH_FUSED_OPERATOR(+, FixedPointAdd)
+FIXMATH_FUSED_OPERATOR(-, FixedPointSubtract)
+
+#undef FIXMATH_FUSED_OPERATOR
+
+template <typename Fixed, typename Operand>
+FixedPointNegate<Fixed, Operand> operator-(const FixedPointExpr<Fixed, Operand> &operand)
+{
+	return FixedPointNegate<Fixed, Operand>(operand.expr());
+}
+
+#endif
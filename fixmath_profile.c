@@ -0,0 +1,124 @@
+#include "fixmath_profile.h"
+
+#ifdef FIXMATH_PROFILE
+#include <stdio.h>
+
+#define DUMP_MAX 64 /* More than the number of profiled functions */
+
+// avr-libc printf has no 64-bit conversions, but AVR builds use NO_64BIT.
+#ifdef FIXMATH_NO_64BIT
+typedef unsigned long ticks_print_t;
+#define TICKS_FMT "lu"
+#else
+typedef unsigned long long ticks_print_t;
+#define TICKS_FMT "llu"
+#endif
+
+// Functions are added at the head of the list on their first call, the
+// tail is the first one called.
+static fixmath_profile_entry_t *_fixmath_profile_head = 0;
+static fixmath_profile_entry_t *_fixmath_profile_tail = 0;
+static fixmath_profile_ticks_t _fixmath_profile_overhead = 0;
+
+static void profile_init(void)
+{
+#ifdef FIXMATH_PROFILE_DWT
+	// Enable the DWT cycle counter: DEMCR.TRCENA, then DWT_CTRL.CYCCNTENA.
+	*(volatile uint32_t *)0xE000EDFC |= (1UL << 24);
+	*(volatile uint32_t *)0xE0001000 |= 1UL;
+#endif
+
+	// The cost of reading the clock twice, subtracted from every call.
+	fixmath_profile_ticks_t best = 0;
+	uint_fast8_t i;
+	for (i = 0; i < 8; i++)
+	{
+		fixmath_profile_ticks_t start = FIXMATH_PROFILE_CLOCK();
+		fixmath_profile_ticks_t ticks = FIXMATH_PROFILE_CLOCK() - start;
+		if (i == 0 || ticks < best)
+			best = ticks;
+	}
+	_fixmath_profile_overhead = best;
+}
+
+void _fixmath_profile_add(fixmath_profile_entry_t *entry, fixmath_profile_ticks_t start)
+{
+	fixmath_profile_ticks_t ticks = FIXMATH_PROFILE_CLOCK() - start;
+
+	if (!entry->next && entry != _fixmath_profile_tail)
+	{
+		// First call of this function
+		if (!_fixmath_profile_tail)
+		{
+			profile_init();
+			_fixmath_profile_tail = entry;
+		}
+		entry->next = _fixmath_profile_head;
+		_fixmath_profile_head = entry;
+	}
+
+	entry->calls++;
+	entry->ticks += (ticks > _fixmath_profile_overhead) ? ticks - _fixmath_profile_overhead : 0;
+}
+
+const fixmath_profile_entry_t *fixmath_profile_first(void)
+{
+	return _fixmath_profile_head;
+}
+
+void fixmath_profile_reset(void)
+{
+	fixmath_profile_entry_t *entry;
+	for (entry = _fixmath_profile_head; entry; entry = entry->next)
+	{
+		entry->calls = 0;
+		entry->ticks = 0;
+	}
+}
+
+/* part / total in tenths of a percent, without overflowing 32-bit ticks. */
+static unsigned permille(fixmath_profile_ticks_t part, fixmath_profile_ticks_t total)
+{
+	while (part > ((fixmath_profile_ticks_t)-1) / 1000)
+	{
+		part >>= 1;
+		total >>= 1;
+	}
+	return total ? (unsigned)(part * 1000 / total) : 0;
+}
+
+void fixmath_profile_dump(void (*print)(const char *line), unsigned top)
+{
+	fixmath_profile_entry_t *sorted[DUMP_MAX];
+	fixmath_profile_entry_t *entry;
+	fixmath_profile_ticks_t total = 0;
+	unsigned count = 0, i, j;
+	char line[80];
+
+	// Insertion sort by ticks, most first.
+	for (entry = _fixmath_profile_head; entry && count < DUMP_MAX; entry = entry->next)
+	{
+		if (!entry->calls)
+			continue;
+		total += entry->ticks;
+		for (i = count++; i > 0 && sorted[i - 1]->ticks < entry->ticks; i--)
+			sorted[i] = sorted[i - 1];
+		sorted[i] = entry;
+	}
+
+	snprintf(line, sizeof(line), "%-18s %10s %12s %10s %6s",
+		"Function", "calls", "ticks", "ticks/call", "%");
+	print(line);
+	for (j = 0; j < count && j < top; j++)
+	{
+		unsigned share = permille(sorted[j]->ticks, total);
+		snprintf(line, sizeof(line), "%-18s %10lu %12" TICKS_FMT " %10" TICKS_FMT " %4u.%u",
+			sorted[j]->name, (unsigned long)sorted[j]->calls,
+			(ticks_print_t)sorted[j]->ticks,
+			(ticks_print_t)(sorted[j]->ticks / sorted[j]->calls),
+			share / 10, share % 10);
+		print(line);
+	}
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef __libfixmath_fixmath_profile_h__
+#define __libfixmath_fixmath_profile_h__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+	\file fixmath_profile.h
+	\brief Call counts and time spent per fix16/fix8 function.
+
+	When the library is built with FIXMATH_PROFILE, every exported function
+	of fix16.h and fix8.h counts its calls and the clock ticks spent in it.
+	Only calls from outside the library are counted, e.g. the fix16_mul
+	calls made by fix16_exp are part of the time of fix16_exp.
+
+	The clock is the TSC on x86, the DWT cycle counter on Cortex-M3/M4/M7,
+	micros() on other Arduino boards and clock() elsewhere. Define
+	FIXMATH_PROFILE_CLOCK() to use another one. The counters are not
+	thread safe.
+*/
+
+#include "libfixmath_conf.h"
+#include <stdint.h>
+
+#ifdef FIXMATH_PROFILE
+
+#ifdef FIXMATH_NO_64BIT
+typedef uint32_t fixmath_profile_ticks_t;
+#else
+typedef uint64_t fixmath_profile_ticks_t;
+#endif
+
+typedef struct fixmath_profile_entry {
+	const char *name;                     /*!< function name */
+	uint32_t calls;                       /*!< number of calls */
+	fixmath_profile_ticks_t ticks;        /*!< clock ticks spent in the calls */
+	struct fixmath_profile_entry *next;   /*!< next function called so far */
+} fixmath_profile_entry_t;
+
+/*! Returns the first of the functions called so far, in no particular order.
+*/
+extern const fixmath_profile_entry_t *fixmath_profile_first(void);
+
+/*! Clears the counters of all functions.
+*/
+extern void fixmath_profile_reset(void);
+
+/*! Prints the top functions by time spent, one line per call of print.
+ */
+extern void fixmath_profile_dump(void (*print)(const char *line), unsigned top);
+
+#if defined(FIXMATH_PROFILE_CLOCK)
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define FIXMATH_PROFILE_CLOCK() __rdtsc()
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define FIXMATH_PROFILE_DWT
+#define FIXMATH_PROFILE_CLOCK() (*(volatile uint32_t *)0xE0001004) /* DWT_CYCCNT */
+#elif defined(ARDUINO)
+extern unsigned long micros(void);
+#define FIXMATH_PROFILE_CLOCK() micros()
+#else
+#include <time.h>
+#define FIXMATH_PROFILE_CLOCK() clock()
+#endif
+
+/* Used by the wrappers in fixmath_wrap.h. */
+extern void _fixmath_profile_add(fixmath_profile_entry_t *entry, fixmath_profile_ticks_t start);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,303 @@
+#ifndef __libfixmath_fixmath_range_hpp__
+#define __libfixmath_fixmath_range_hpp__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "fix16.hpp"
+#include "fix8.hpp"
+
+/* Fix16Range and Fix8Range record the values of named variables. They are
+ * only declared here, not by fix16.hpp and fix8.hpp, so that programs which
+ * do not use them do not pull in stdio and the heap.
+ */
+
+/* Value range of one named Fix16Range or Fix8Range variable: the values
+ * assigned to it, and how many of them had fractional bits rounded away or
+ * overflowed on the way. Tells whether a variable fits a narrower format.
+ *
+ * All variables constructed with the same name share one record. Records
+ * are created on first use and never freed.
+ */
+struct FixmathRange
+{
+	const char *name;
+	uint8_t  frac_bits;    // Of the format the variable is in, 16 or 8
+	int32_t  min, max;     // Raw values, without the overflowed writes
+	uint32_t min_nonzero;  // Smallest nonzero magnitude, raw
+	uint32_t writes;       // Values assigned
+	uint32_t lossy;        // Operations which rounded away fractional bits
+	uint32_t overflows;
+	FixmathRange *next;
+
+	static FixmathRange *&first() { static FixmathRange *head = 0; return head; }
+
+	static FixmathRange *get(const char *name, uint8_t frac_bits)
+	{
+		FixmathRange *r;
+		for (r = first(); r; r = r->next)
+		{
+			if (r->frac_bits == frac_bits && (r->name == name || !strcmp(r->name, name)))
+				return r;
+		}
+		r = new FixmathRange();
+		r->name = name;
+		r->frac_bits = frac_bits;
+		r->next = first();
+		first() = r;
+		return r;
+	}
+
+	/* An overflowed write is counted, but its value, the overflow value or
+	 * a saturated one, is not the range the variable needs. */
+	void record(int32_t raw, uint32_t lost, uint32_t overflowed)
+	{
+		bool first = writes == overflows;
+		writes++;
+		lossy += lost;
+		overflows += overflowed;
+		if (overflowed)
+			return;
+		if (first || raw < min) min = raw;
+		if (first || raw > max) max = raw;
+		uint32_t magnitude = raw < 0 ? 0 - (uint32_t)raw : (uint32_t)raw;
+		if (magnitude && (min_nonzero == 0 || magnitude < min_nonzero))
+			min_nonzero = magnitude;
+	}
+
+	/* Integer bits, including the sign, needed for min..max. */
+	uint8_t int_bits() const
+	{
+		uint8_t bits = 1;
+		while (bits < 32 && (min < -((int32_t)1 << (bits - 1)) || max > (int32_t)(((uint32_t)1 << (bits - 1)) - 1)))
+			bits++;
+		return bits > frac_bits ? bits - frac_bits : 1;
+	}
+
+	/* Fractional bits needed to keep the smallest magnitude nonzero. */
+	uint8_t frac_bits_needed() const
+	{
+		uint8_t bits = frac_bits;
+		uint32_t m = min_nonzero;
+		while (m > 1 && bits > 0)
+		{
+			m >>= 1;
+			bits--;
+		}
+		return min_nonzero ? bits : 0;
+	}
+
+	static void reset()
+	{
+		for (FixmathRange *r = first(); r; r = r->next)
+		{
+			r->min = r->max = 0;
+			r->min_nonzero = r->writes = r->lossy = r->overflows = 0;
+		}
+	}
+
+	/* One line per variable: format, range, smallest magnitude, operations
+	 * and the bits needed. */
+	static void dump(void (*print)(const char *line))
+	{
+		char line[192], lo[24], hi[24], small[24];
+		snprintf(line, sizeof(line), "%-16s %-5s %12s %12s %12s %8s %6s %6s %5s %5s",
+			"Variable", "fmt", "min", "max", "min |x|>0", "writes", "lossy", "ovfl",
+			"int", "frac");
+		print(line);
+		for (FixmathRange *r = first(); r; r = r->next)
+		{
+			if (!r->writes)
+				continue;
+			format(lo, r->min, r->frac_bits);
+			format(hi, r->max, r->frac_bits);
+			format(small, (int32_t)r->min_nonzero, r->frac_bits);
+			snprintf(line, sizeof(line), "%-16s %-5s %12s %12s %12s %8lu %6lu %6lu %5u %5u",
+				r->name, r->frac_bits == 16 ? "16.16" : "8.8", lo, hi, small,
+				(unsigned long)r->writes, (unsigned long)r->lossy,
+				(unsigned long)r->overflows, r->int_bits(), r->frac_bits_needed());
+			print(line);
+		}
+	}
+
+	/* Decimal representation with 5 digits, truncated, into 24 bytes, without
+	 * needing printf float support. */
+	static void format(char *buf, int32_t raw, uint8_t frac_bits)
+	{
+		uint32_t magnitude = raw < 0 ? 0 - (uint32_t)raw : (uint32_t)raw;
+		uint32_t frac = magnitude & (((uint32_t)1 << frac_bits) - 1);
+		uint32_t digits = (uint32_t)(((uint64_t)frac * 100000) >> frac_bits);
+		snprintf(buf, 24, "%s%lu.%05lu", raw < 0 ? "-" : "",
+			(unsigned long)(magnitude >> frac_bits), (unsigned long)digits);
+	}
+};
+
+/* Drop-in replacement for Fix16 which records the range of values of a
+ * named variable, see FixmathRange::dump():
+ *
+ *   Fix16Range speed("speed");    instead of   Fix16 speed;
+ *
+ * Results of the arithmetic operators are unnamed temporaries, which carry
+ * the count of rounding operations along to the variable they are assigned
+ * to. The left operand needs to be a Fix16Range for that, mixed
+ * expressions starting with a plain Fix16 only record the final value.
+ *
+ * The arithmetic is that of Fix16, through Fix16::Ops, so the results are the
+ * same.
+ */
+class Fix16Range : public Fix16 {
+	public:
+		FixmathRange *range;  // NULL for temporaries
+		uint32_t lost;        // Rounding operations of a temporary
+		uint32_t overflowed;  // Overflows of a temporary
+
+		explicit Fix16Range(const char *name) : Fix16(), range(FixmathRange::get(name, 16)), lost(0), overflowed(0) {}
+		template <typename T> Fix16Range(const char *name, const T &init)
+			: Fix16(), range(FixmathRange::get(name, 16)), lost(0), overflowed(0) { *this = init; }
+		Fix16Range(const Fix16Range &other)
+			: Fix16(other.value), range(0), lost(other.lost), overflowed(other.overflowed) {}
+
+		Fix16Range & operator=(const Fix16Range &rhs) { value = rhs.value; note(rhs.lost, rhs.overflowed); return *this; }
+		template <typename T> Fix16Range & operator=(const T &rhs)
+			{ uint32_t l = 0; value = raw(rhs, l); note(l, 0); return *this; }
+
+		template <typename T> Fix16Range & operator+=(const T &rhs)
+			{ uint32_t l = 0; fix16_t b = raw(rhs, l); value = Ops::add(value, b); note(l, 0); return *this; }
+		template <typename T> Fix16Range & operator-=(const T &rhs)
+			{ uint32_t l = 0; fix16_t b = raw(rhs, l); value = Ops::sub(value, b); note(l, 0); return *this; }
+		template <typename T> Fix16Range & operator*=(const T &rhs)
+		{
+			uint32_t l = 0;
+			fix16_t b = raw(rhs, l);
+			l += (((int64_t)value * b) & 0xFFFF) != 0;
+			value = Ops::mul(value, b);
+			note(l, 0);
+			return *this;
+		}
+		template <typename T> Fix16Range & operator/=(const T &rhs)
+		{
+			uint32_t l = 0;
+			fix16_t b = raw(rhs, l);
+			l += b != 0 && (((int64_t)value * 65536) % b) != 0;
+			value = Ops::div(value, b);
+			note(l, 0);
+			return *this;
+		}
+
+		template <typename T> const Fix16Range operator+(const T &other) const { Fix16Range ret = *this; ret += other; return ret; }
+		template <typename T> const Fix16Range operator-(const T &other) const { Fix16Range ret = *this; ret -= other; return ret; }
+		template <typename T> const Fix16Range operator*(const T &other) const { Fix16Range ret = *this; ret *= other; return ret; }
+		template <typename T> const Fix16Range operator/(const T &other) const { Fix16Range ret = *this; ret /= other; return ret; }
+
+	private:
+		/* Records the result of an operation, or keeps its counts along with
+		 * a temporary. Results equal to fix16_overflow count as overflows. */
+		void note(uint32_t l, uint32_t o)
+		{
+#ifndef FIXMATH_NO_OVERFLOW
+			if (value == fix16_overflow && !o) { o = 1; l = 0; }
+#endif
+			if (range)
+				range->record(value, l, o);
+			else
+			{
+				lost += l;
+				overflowed += o;
+			}
+		}
+
+		static fix16_t raw(const Fix16Range &x, uint32_t &l) { l += x.lost; return x.value; }
+		static fix16_t raw(const Fix16 &x, uint32_t &)       { return x.value; }
+		static fix16_t raw(const fix16_t x, uint32_t &)      { return x; }
+		static fix16_t raw(const int16_t x, uint32_t &)      { return Ops::from_int(x); }
+		static fix16_t raw(const double x, uint32_t &l)
+			{ fix16_t r = Ops::from_dbl(x); l += Ops::to_dbl(r) != x; return r; }
+		static fix16_t raw(const float x, uint32_t &l)
+			{ fix16_t r = Ops::from_float(x); l += Ops::to_float(r) != x; return r; }
+};
+
+/* Drop-in replacement for Fix8 which records the range of values of a
+ * named variable, see FixmathRange::dump():
+ *
+ *   Fix8Range speed("speed");    instead of   Fix8 speed;
+ *
+ * Results of the arithmetic operators are unnamed temporaries, which carry
+ * the count of rounding operations along to the variable they are assigned
+ * to. The left operand needs to be a Fix8Range for that, mixed
+ * expressions starting with a plain Fix8 only record the final value.
+ *
+ * The arithmetic is that of Fix8, through Fix8::Ops, so the results are the
+ * same.
+ */
+class Fix8Range : public Fix8 {
+	public:
+		FixmathRange *range;  // NULL for temporaries
+		uint32_t lost;        // Rounding operations of a temporary
+		uint32_t overflowed;  // Overflows of a temporary
+
+		explicit Fix8Range(const char *name) : Fix8(), range(FixmathRange::get(name, 8)), lost(0), overflowed(0) {}
+		template <typename T> Fix8Range(const char *name, const T &init)
+			: Fix8(), range(FixmathRange::get(name, 8)), lost(0), overflowed(0) { *this = init; }
+		Fix8Range(const Fix8Range &other)
+			: Fix8(other.value), range(0), lost(other.lost), overflowed(other.overflowed) {}
+
+		Fix8Range & operator=(const Fix8Range &rhs) { value = rhs.value; note(rhs.lost, rhs.overflowed); return *this; }
+		template <typename T> Fix8Range & operator=(const T &rhs)
+			{ uint32_t l = 0; value = raw(rhs, l); note(l, 0); return *this; }
+
+		template <typename T> Fix8Range & operator+=(const T &rhs)
+			{ uint32_t l = 0; fix8_t b = raw(rhs, l); value = Ops::add(value, b); note(l, 0); return *this; }
+		template <typename T> Fix8Range & operator-=(const T &rhs)
+			{ uint32_t l = 0; fix8_t b = raw(rhs, l); value = Ops::sub(value, b); note(l, 0); return *this; }
+		template <typename T> Fix8Range & operator*=(const T &rhs)
+		{
+			uint32_t l = 0;
+			fix8_t b = raw(rhs, l);
+			l += (((int32_t)value * b) & 0xFF) != 0;
+			value = Ops::mul(value, b);
+			note(l, 0);
+			return *this;
+		}
+		template <typename T> Fix8Range & operator/=(const T &rhs)
+		{
+			uint32_t l = 0;
+			fix8_t b = raw(rhs, l);
+			l += b != 0 && (((int32_t)value * 256) % b) != 0;
+			value = Ops::div(value, b);
+			note(l, 0);
+			return *this;
+		}
+
+		template <typename T> const Fix8Range operator+(const T &other) const { Fix8Range ret = *this; ret += other; return ret; }
+		template <typename T> const Fix8Range operator-(const T &other) const { Fix8Range ret = *this; ret -= other; return ret; }
+		template <typename T> const Fix8Range operator*(const T &other) const { Fix8Range ret = *this; ret *= other; return ret; }
+		template <typename T> const Fix8Range operator/(const T &other) const { Fix8Range ret = *this; ret /= other; return ret; }
+
+	private:
+		/* Records the result of an operation, or keeps its counts along with
+		 * a temporary. Results equal to fix8_overflow count as overflows. */
+		void note(uint32_t l, uint32_t o)
+		{
+#ifndef FIXMATH_NO_OVERFLOW
+			if (value == fix8_overflow && !o) { o = 1; l = 0; }
+#endif
+			if (range)
+				range->record(value, l, o);
+			else
+			{
+				lost += l;
+				overflowed += o;
+			}
+		}
+
+		static fix8_t raw(const Fix8Range &x, uint32_t &l) { l += x.lost; return x.value; }
+		static fix8_t raw(const Fix8 &x, uint32_t &)       { return x.value; }
+		static fix8_t raw(const fix8_t x, uint32_t &)      { return x; }
+		static fix8_t raw(const int8_t x, uint32_t &)      { return Ops::from_int(x); }
+		static fix8_t raw(const double x, uint32_t &l)
+			{ fix8_t r = Ops::from_dbl(x); l += Ops::to_dbl(r) != x; return r; }
+		static fix8_t raw(const float x, uint32_t &l)
+			{ fix8_t r = Ops::from_float(x); l += Ops::to_float(r) != x; return r; }
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "fixmath_trace.h"
+
+#if defined(FIXMATH_TRACE_OVERFLOW) && !defined(FIXMATH_NO_OVERFLOW)
+#include <stdio.h>
+#include <string.h>
+
+static fixmath_trace_event_t _fixmath_trace_events[FIXMATH_TRACE_EVENTS];
+static fixmath_trace_site_t _fixmath_trace_sites[FIXMATH_TRACE_SITES];
+static unsigned _fixmath_trace_site_count = 0;
+static uint32_t _fixmath_trace_total = 0;
+// Next event to write and events in the ring buffer. The total may wrap
+// around, so it does not index the buffer.
+static unsigned _fixmath_trace_head = 0;
+static unsigned _fixmath_trace_used = 0;
+
+static const char *const _fixmath_op_names[] = {
+	"fix16_add", "fix16_sub", "fix16_mul", "fix16_div",
+	"fix8_add", "fix8_sub", "fix8_mul", "fix8_div"
+};
+
+void _fixmath_trace_overflow(fixmath_op_t op, int32_t a, int32_t b, const void *caller)
+{
+	fixmath_trace_event_t *event = &_fixmath_trace_events[_fixmath_trace_head];
+	unsigned i;
+
+	event->op = op;
+	event->a = a;
+	event->b = b;
+	event->caller = caller;
+	_fixmath_trace_total++;
+	if (++_fixmath_trace_head == FIXMATH_TRACE_EVENTS)
+		_fixmath_trace_head = 0;
+	if (_fixmath_trace_used < FIXMATH_TRACE_EVENTS)
+		_fixmath_trace_used++;
+
+	for (i = 0; i < _fixmath_trace_site_count; i++)
+	{
+		if (_fixmath_trace_sites[i].caller == caller)
+		{
+			_fixmath_trace_sites[i].count++;
+			return;
+		}
+	}
+	if (i < FIXMATH_TRACE_SITES)
+	{
+		_fixmath_trace_sites[i].caller = caller;
+		_fixmath_trace_sites[i].count = 1;
+		_fixmath_trace_site_count++;
+	}
+}
+
+uint32_t fixmath_trace_count(void)
+{
+	return _fixmath_trace_total;
+}
+
+int fixmath_trace_event(unsigned n, fixmath_trace_event_t *event)
+{
+	if (n >= _fixmath_trace_used)
+		return 0;
+	*event = _fixmath_trace_events[(_fixmath_trace_head + FIXMATH_TRACE_EVENTS - 1 - n) % FIXMATH_TRACE_EVENTS];
+	return 1;
+}
+
+const fixmath_trace_site_t *fixmath_trace_sites(unsigned *count)
+{
+	*count = _fixmath_trace_site_count;
+	return _fixmath_trace_sites;
+}
+
+const char *fixmath_trace_op_name(fixmath_op_t op)
+{
+	return _fixmath_op_names[op];
+}
+
+void fixmath_trace_reset(void)
+{
+	memset(_fixmath_trace_events, 0, sizeof(_fixmath_trace_events));
+	memset(_fixmath_trace_sites, 0, sizeof(_fixmath_trace_sites));
+	_fixmath_trace_total = 0;
+	_fixmath_trace_head = 0;
+	_fixmath_trace_used = 0;
+	_fixmath_trace_site_count = 0;
+}
+
+void fixmath_trace_dump(void (*print)(const char *line))
+{
+	char line[80];
+	unsigned i, j;
+	fixmath_trace_event_t event;
+
+	snprintf(line, sizeof(line), "%lu overflows at %u call sites",
+		(unsigned long)_fixmath_trace_total, _fixmath_trace_site_count);
+	print(line);
+
+	// Sites by count, largest first
+	fixmath_trace_site_t sorted[FIXMATH_TRACE_SITES];
+	for (i = 0; i < _fixmath_trace_site_count; i++)
+	{
+		for (j = i; j > 0 && sorted[j - 1].count < _fixmath_trace_sites[i].count; j--)
+			sorted[j] = sorted[j - 1];
+		sorted[j] = _fixmath_trace_sites[i];
+	}
+	for (i = 0; i < _fixmath_trace_site_count; i++)
+	{
+		snprintf(line, sizeof(line), "  site %p: %lu", sorted[i].caller,
+			(unsigned long)sorted[i].count);
+		print(line);
+	}
+
+	for (i = 0; fixmath_trace_event(i, &event); i++)
+	{
+		snprintf(line, sizeof(line), "  %s(0x%08lx, 0x%08lx) called from %p",
+			fixmath_trace_op_name(event.op), (unsigned long)(uint32_t)event.a,
+			(unsigned long)(uint32_t)event.b, event.caller);
+		print(line);
+	}
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef __libfixmath_fixmath_trace_h__
+#define __libfixmath_fixmath_trace_h__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+	\file fixmath_trace.h
+	\brief Records where fix16/fix8 operations overflow.
+
+	fix16_add, fix16_sub, fix16_mul and fix16_div (and their fix8
+	counterparts) return fix16_overflow on overflow, which equals
+	fix16_minimum and is silently used by the following calculations. When
+	the library is built with FIXMATH_TRACE_OVERFLOW, each call from the
+	application which returns the overflow value is recorded with its
+	operands and the address it was called from, into a ring buffer of the
+	last FIXMATH_TRACE_EVENTS events, and counted per call site for up to
+	FIXMATH_TRACE_SITES sites. The addresses can be turned into source
+	lines with addr2line, after which the hot sites can be changed to the
+	saturating variants.
+
+	A result of exactly fix16_minimum is indistinguishable from an overflow
+	and recorded as well, except with FIXMATH_STICKY_OVERFLOW, where the
+	overflow flag tells. Has no effect with FIXMATH_NO_OVERFLOW, and is not
+	thread safe.
+*/
+
+#include "libfixmath_conf.h"
+#include <stdint.h>
+
+#if defined(FIXMATH_TRACE_OVERFLOW) && !defined(FIXMATH_NO_OVERFLOW)
+
+#ifndef FIXMATH_TRACE_EVENTS
+#define FIXMATH_TRACE_EVENTS 16
+#endif
+
+#ifndef FIXMATH_TRACE_SITES
+#define FIXMATH_TRACE_SITES 16
+#endif
+
+typedef enum {
+	FIXMATH_OP_FIX16_ADD,
+	FIXMATH_OP_FIX16_SUB,
+	FIXMATH_OP_FIX16_MUL,
+	FIXMATH_OP_FIX16_DIV,
+	FIXMATH_OP_FIX8_ADD,
+	FIXMATH_OP_FIX8_SUB,
+	FIXMATH_OP_FIX8_MUL,
+	FIXMATH_OP_FIX8_DIV
+} fixmath_op_t;
+
+typedef struct {
+	fixmath_op_t op;
+	int32_t a, b;           /*!< operands */
+	const void *caller;     /*!< return address into the calling function */
+} fixmath_trace_event_t;
+
+typedef struct {
+	const void *caller;
+	uint32_t count;         /*!< overflows at this call site */
+} fixmath_trace_site_t;
+
+/*! Returns the total number of overflows since the last reset.
+*/
+extern uint32_t fixmath_trace_count(void);
+
+/*! Copies the n-th most recent overflow to event, returns 0 if there are
+ *  fewer than n + 1 in the buffer.
+ */
+extern int fixmath_trace_event(unsigned n, fixmath_trace_event_t *event);
+
+/*! Returns the call sites seen so far and their number in count. Overflows
+ *  at further sites are only included in fixmath_trace_count().
+ */
+extern const fixmath_trace_site_t *fixmath_trace_sites(unsigned *count);
+
+/*! Returns the name of the operation, e.g. "fix16_mul".
+*/
+extern const char *fixmath_trace_op_name(fixmath_op_t op);
+
+/*! Clears the events and the counters.
+*/
+extern void fixmath_trace_reset(void);
+
+/*! Prints the call sites by number of overflows, then the recorded
+ *  events, most recent first, one line per call of print.
+ */
+extern void fixmath_trace_dump(void (*print)(const char *line));
+
+/* Used by the wrappers in fixmath_wrap.h. */
+extern void _fixmath_trace_overflow(fixmath_op_t op, int32_t a, int32_t b, const void *caller);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef __libfixmath_fixmath_wrap_h__
+#define __libfixmath_fixmath_wrap_h__
+
+/* Included first by the library sources. With FIXMATH_PROFILE or
+ * FIXMATH_TRACE_OVERFLOW, the functions are compiled as _<name>_raw, and
+ * each source defines the public names as wrappers at its end, which
+ * profile the call (see fixmath_profile.h) and record overflows (see
+ * fixmath_trace.h). Calls within the library go to the _raw functions, so
+ * only the application's calls are seen.
+ *
+ * With FIXMATH_VARIANT defined to a prefix, e.g. nr, the functions of
+ * fix16.c are compiled as fix16_nr_mul etc. instead, which can be linked
+ * next to the default ones (see fix16_variant.h). Variants are always out
+ * of line, and not profiled or traced.
+ */
+#ifdef FIXMATH_VARIANT
+#undef FIXMATH_INLINE
+#undef FIXMATH_PROFILE
+#undef FIXMATH_TRACE_OVERFLOW
+
+#define _FIXMATH_VARIANT_NAME2(prefix, name) fix16_##prefix##_##name
+#define _FIXMATH_VARIANT_NAME(prefix, name)  _FIXMATH_VARIANT_NAME2(prefix, name)
+
+#define fix16_add           _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, add)
+#define fix16_sub           _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, sub)
+#define fix16_sadd          _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, sadd)
+#define fix16_ssub          _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, ssub)
+#define fix16_mul           _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, mul)
+#define fix16_div           _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, div)
+#define fix16_smul          _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, smul)
+#define fix16_sdiv          _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, sdiv)
+#define fix16_mul_checked   _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, mul_checked)
+#define fix16_div_checked   _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, div_checked)
+#define fix16_recip         _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, recip)
+#define fix16_divider       _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, divider)
+#define fix16_div_by_array  _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, div_by_array)
+#define fix16_mod           _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, mod)
+#define fix16_lerp8         _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, lerp8)
+#define fix16_lerp16        _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, lerp16)
+#define fix16_lerp32        _FIXMATH_VARIANT_NAME(FIXMATH_VARIANT, lerp32)
+#endif
+
+#include "libfixmath_conf.h"
+
+#if defined(FIXMATH_PROFILE) || defined(FIXMATH_TRACE_OVERFLOW)
+#define FIXMATH_WRAP
+#define fix16_add          _fix16_add_raw
+#define fix16_sub          _fix16_sub_raw
+#define fix16_sadd         _fix16_sadd_raw
+#define fix16_ssub         _fix16_ssub_raw
+#define fix16_mul          _fix16_mul_raw
+#define fix16_div          _fix16_div_raw
+#define fix16_smul         _fix16_smul_raw
+#define fix16_sdiv         _fix16_sdiv_raw
+#define fix16_mul_checked  _fix16_mul_checked_raw
+#define fix16_div_checked  _fix16_div_checked_raw
+#define fix16_recip        _fix16_recip_raw
+#define fix16_divider      _fix16_divider_raw
+#define fix16_div_by_array _fix16_div_by_array_raw
+#define fix16_mod          _fix16_mod_raw
+#define fix16_lerp8        _fix16_lerp8_raw
+#define fix16_lerp16       _fix16_lerp16_raw
+#define fix16_lerp32       _fix16_lerp32_raw
+#define fix16_sin_parabola _fix16_sin_parabola_raw
+#define fix16_sin          _fix16_sin_raw
+#define fix16_cos          _fix16_cos_raw
+#define fix16_tan          _fix16_tan_raw
+#define fix16_asin         _fix16_asin_raw
+#define fix16_acos         _fix16_acos_raw
+#define fix16_atan         _fix16_atan_raw
+#define fix16_atan2        _fix16_atan2_raw
+#define fix16_sqrt         _fix16_sqrt_raw
+#define fix16_exp          _fix16_exp_raw
+#define fix16_log          _fix16_log_raw
+#define fix16_log2         _fix16_log2_raw
+#define fix16_slog2        _fix16_slog2_raw
+#define fix16_to_str       _fix16_to_str_raw
+#define fix16_from_str     _fix16_from_str_raw
+
+#define fix8_add           _fix8_add_raw
+#define fix8_sub           _fix8_sub_raw
+#define fix8_sadd          _fix8_sadd_raw
+#define fix8_ssub          _fix8_ssub_raw
+#define fix8_mul           _fix8_mul_raw
+#define fix8_div           _fix8_div_raw
+#define fix8_smul          _fix8_smul_raw
+#define fix8_sdiv          _fix8_sdiv_raw
+#define fix8_mod           _fix8_mod_raw
+#define fix8_lerp8         _fix8_lerp8_raw
+#define fix8_lerp16        _fix8_lerp16_raw
+#define fix8_lerp32        _fix8_lerp32_raw
+
+#include "fixmath_profile.h"
+#include "fixmath_trace.h"
+
+#ifdef FIXMATH_PROFILE
+#define FIXMATH_WRAP_BEGIN(name) \
+	static fixmath_profile_entry_t entry = { #name, 0, 0, 0 }; \
+	fixmath_profile_ticks_t start = FIXMATH_PROFILE_CLOCK();
+#define FIXMATH_WRAP_END() _fixmath_profile_add(&entry, start);
+#else
+#define FIXMATH_WRAP_BEGIN(name)
+#define FIXMATH_WRAP_END()
+#endif
+
+/* The caller's address identifies the overflowing expression, so the
+ * wrapper must not be inlined into it. */
+#if defined(FIXMATH_TRACE_OVERFLOW) && !defined(FIXMATH_NO_OVERFLOW) && defined(__GNUC__)
+#define FIXMATH_WRAP_ATTRS __attribute__((noinline))
+#define FIXMATH_WRAP_CALLER __builtin_return_address(0)
+#else
+#define FIXMATH_WRAP_ATTRS
+#define FIXMATH_WRAP_CALLER 0
+#endif
+
+/* With FIXMATH_STICKY_OVERFLOW the results are saturated, so the flag
+ * tells whether this call overflowed. It is cleared before the call and
+ * the earlier state ORed back in afterwards.
+ */
+#if defined(FIXMATH_TRACE_OVERFLOW) && defined(FIXMATH_STICKY_OVERFLOW)
+#define FIXMATH_WRAP_STICKY() \
+	uint8_t sticky = _fixmath_overflow_flag; \
+	_fixmath_overflow_flag = 0;
+#define FIXMATH_WRAP_TRACE(op, result, overflow) \
+	if (_fixmath_overflow_flag) \
+		_fixmath_trace_overflow(op, a, b, FIXMATH_WRAP_CALLER); \
+	_fixmath_overflow_flag |= sticky;
+#elif defined(FIXMATH_TRACE_OVERFLOW) && !defined(FIXMATH_NO_OVERFLOW)
+#define FIXMATH_WRAP_STICKY()
+#define FIXMATH_WRAP_TRACE(op, result, overflow) \
+	if (result == overflow) \
+		_fixmath_trace_overflow(op, a, b, FIXMATH_WRAP_CALLER);
+#else
+#define FIXMATH_WRAP_STICKY()
+#define FIXMATH_WRAP_TRACE(op, result, overflow)
+#endif
+
+/* Define the public function name as a wrapper around _<name>_raw. The
+ * name must be #undef'd first.
+ */
+#define FIXMATH_WRAP1(ret, name, t0) \
+	ret name(t0 a) \
+	{ \
+		FIXMATH_WRAP_BEGIN(name) \
+		ret result = _##name##_raw(a); \
+		FIXMATH_WRAP_END() \
+		return result; \
+	}
+
+#define FIXMATH_WRAP2(ret, name, t0, t1) \
+	ret name(t0 a, t1 b) \
+	{ \
+		FIXMATH_WRAP_BEGIN(name) \
+		ret result = _##name##_raw(a, b); \
+		FIXMATH_WRAP_END() \
+		return result; \
+	}
+
+/* Same for the operations which return overflow as their result. */
+#define FIXMATH_WRAP2_OVERFLOW(ret, name, op, overflow) \
+	FIXMATH_WRAP_ATTRS ret name(ret a, ret b) \
+	{ \
+		FIXMATH_WRAP_BEGIN(name) \
+		FIXMATH_WRAP_STICKY() \
+		ret result = _##name##_raw(a, b); \
+		FIXMATH_WRAP_END() \
+		FIXMATH_WRAP_TRACE(op, result, overflow) \
+		return result; \
+	}
+
+#define FIXMATH_WRAP3(ret, name, t0, t1, t2) \
+	ret name(t0 a, t1 b, t2 c) \
+	{ \
+		FIXMATH_WRAP_BEGIN(name) \
+		ret result = _##name##_raw(a, b, c); \
+		FIXMATH_WRAP_END() \
+		return result; \
+	}
+
+#define FIXMATH_WRAP3_VOID(name, t0, t1, t2) \
+	void name(t0 a, t1 b, t2 c) \
+	{ \
+		FIXMATH_WRAP_BEGIN(name) \
+		_##name##_raw(a, b, c); \
+		FIXMATH_WRAP_END() \
+	}
+
+#define FIXMATH_WRAP4_VOID(name, t0, t1, t2, t3) \
+	void name(t0 a, t1 b, t2 c, t3 d) \
+	{ \
+		FIXMATH_WRAP_BEGIN(name) \
+		_##name##_raw(a, b, c, d); \
+		FIXMATH_WRAP_END() \
+	}
+#endif
+
+#endif
@@ -12,4 +12,28 @@
 //#define FIXMATH_NO_ROUNDING
 #endif
 
+// FIXMATH_DIV64 makes fix16_div one 64 by 64-bit division, which 64-bit
+// processors do in one instruction, faster than the iterative fix16_div.
+// Its results are rounded exactly, which for divisors of 16.0 and above is
+// sometimes 1 LSB off those of the iterative one, so it is not the default.
+#if defined(FIXMATH_NO_64BIT) || defined(FIXMATH_OPTIMIZE_8BIT)
+#undef FIXMATH_DIV64
+#endif
+
+// The sticky overflow flag replaces the overflow value, so it needs overflow
+// detection. Where the compiler supports it, each thread has its own flag.
+#ifdef FIXMATH_NO_OVERFLOW
+#undef FIXMATH_STICKY_OVERFLOW
+#endif
+
+#if defined(FIXMATH_STICKY_OVERFLOW) && !defined(FIXMATH_THREAD_LOCAL)
+#if defined(__GNUC__) && (defined(__linux__) || defined(__APPLE__) || defined(_WIN32))
+#define FIXMATH_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define FIXMATH_THREAD_LOCAL __declspec(thread)
+#else
+#define FIXMATH_THREAD_LOCAL
+#endif
+#endif
+
 #endif